@@ -5,54 +5,13 @@
 #include <iostream>
 #include <future>
 #include <random>
+#include <chrono>
+#include <cmath>
 
-// 1) POSITION TABLES (Piece-Square Tables)
+// 1) MATERIAL VALUES
 
-// Bonus/malus according to the occupied square. Index 0..63.
-
-const int pawnTable[64] = {
-    0,  0,  0,  0,  0,  0,  0,  0,
-    50, 50, 50, 50, 50, 50, 50, 50,
-    10, 10, 20, 30, 30, 20, 10, 10,
-    5,  5, 10, 25, 25, 10,  5,  5,
-    0,  0,  0, 20, 20,  0,  0,  0,
-    5, -5,-10,  0,  0,-10, -5,  5,
-    5, 10, 10,-20,-20, 10, 10,  5,
-    0,  0,  0,  0,  0,  0,  0,  0
-};
-
-const int knightTable[64] = {
-    -50,-40,-30,-30,-30,-30,-40,-50,
-    -40,-20,  0,  5,  5,  0,-20,-40,
-    -30,  5, 10, 15, 15, 10,  5,-30,
-    -30,  0, 15, 20, 20, 15,  0,-30,
-    -30,  5, 15, 20, 20, 15,  5,-30,
-    -30,  0, 10, 15, 15, 10,  0,-30,
-    -40,-20,  0,  0,  0,  0,-20,-40,
-    -50,-40,-30,-30,-30,-30,-40,-50
-};
-
-const int bishopTable[64] = {
-    -20,-10,-10,-10,-10,-10,-10,-20,
-    -10,  5,  0,  0,  0,  0,  5,-10,
-    -10, 10, 10, 10, 10, 10, 10,-10,
-    -10,  0, 10, 10, 10, 10,  0,-10,
-    -10,  5,  5, 10, 10,  5,  5,-10,
-    -10,  0,  5, 10, 10,  5,  0,-10,
-    -10,  0,  0,  0,  0,  0,  0,-10,
-    -20,-10,-10,-10,-10,-10,-10,-20
-};
-
-const int rookTable[64] = {
-    0,  0,  0,  0,  0,  0,  0,  0,
-    5, 10, 10, 10, 10, 10, 10,  5,
-    -5,  0,  0,  0,  0,  0,  0, -5,
-    -5,  0,  0,  0,  0,  0,  0, -5,
-    -5,  0,  0,  0,  0,  0,  0, -5,
-    -5,  0,  0,  0,  0,  0,  0, -5,
-    -5,  0,  0,  0,  0,  0,  0, -5,
-    0,  0,  0,  5,  5,  0,  0,  0
-};
+// Piece-square tables and the tapered material live in psqt.cpp and are summed
+// incrementally by the board; these single values are only used for move ordering.
 
 // Material values (extended array for “fairy” pieces)
 const int pieceValues[] = {
@@ -67,6 +26,26 @@ Move AI::getMove(Game& g) {
     return getBestMove(g.board(), g.currentTurn());
 }
 
+// Milliseconds on the monotonic clock (used for search deadlines)
+static int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Search counters; built with TDLOG_NO_SEARCH_STATS they cost nothing
+#ifdef TDLOG_NO_SEARCH_STATS
+#define SEARCH_STAT(td, counter) ((void)0)
+#else
+#define SEARCH_STAT(td, counter) (++(td).stats.counter)
+#endif
+
+// Hash of the position, distinguishing the side to move
+static uint64_t positionKey(const Board& board, Color turn) {
+    uint64_t hash = board.getHash();
+    if (turn == Color::Black) hash = ~hash;
+    return hash;
+}
+
 
 // 3) EVALUATION (compatible fairy pieces)
 
@@ -82,66 +61,246 @@ static inline int getLSB(uint64_t bb) {
 #endif
 }
 
-int MaterialAndPositionEvaluation::operator()(const Board& board) const {
-    int score = 0;
-
-    // We loop up to 10 to include fairy pieces
-    for (int p = 0; p < 10; ++p) {
-        PieceType pt = static_cast<PieceType>(p);
-        int val = pieceValues[p];
-
-        // --- White ---
-        Bitboard bbWhite = board.getBitboard(Color::White, pt);
-        while (bbWhite) {
-            int sq = getLSB(bbWhite);
-            int posVal = 0;
-
-            // Position bonus according to the piece type
-            switch(pt) {
-            case PieceType::Pawn:        posVal = pawnTable[sq]; break;
-            case PieceType::Knight:      posVal = knightTable[sq]; break;
-            case PieceType::Bishop:      posVal = bishopTable[sq]; break;
-            case PieceType::Rook:        posVal = rookTable[sq]; break;
-            case PieceType::Princess:    posVal = bishopTable[sq]; break;
-            case PieceType::Empress:     posVal = rookTable[sq]; break;
-            case PieceType::Nightrider:  posVal = knightTable[sq]; break;
-            case PieceType::Grasshopper: posVal = knightTable[sq]; break;
-            default: break;
+// --- Pawn structure ---
+
+// Packed (middlegame, endgame) terms
+const Score PASSED_PAWN_BONUS[8] = { // by relative rank
+    makeScore(0, 0),  makeScore(5, 10),  makeScore(10, 15), makeScore(15, 25),
+    makeScore(25, 45), makeScore(40, 75), makeScore(70, 120), makeScore(0, 0)
+};
+const Score ISOLATED_PAWN_PENALTY = makeScore(15, 10);
+const Score DOUBLED_PAWN_PENALTY  = makeScore(10, 20);
+const Score BACKWARD_PAWN_PENALTY = makeScore(8, 6);
+const Score PAWN_SHIELD_BONUS     = makeScore(10, 0); // per pawn sheltering a king on its first two ranks
+
+const Bitboard FILE_A = 0x0101010101010101ULL;
+const Bitboard FILE_H = 0x8080808080808080ULL;
+
+// Bitboard masks used by the pawn-structure evaluation
+struct PawnMasks {
+    Bitboard file[8];
+    Bitboard adjacentFiles[8];
+    Bitboard passed[2][64];  // same and adjacent files, strictly ahead: enemy pawns there stop a passer
+    Bitboard support[2][64]; // adjacent files, same rank or behind: friendly pawns there can still defend
+    Bitboard front[2][64];   // same file, strictly ahead: the promotion path
+    Bitboard shield[2][64];  // three files around the king, one and two ranks ahead
+
+    PawnMasks() {
+        for (int f = 0; f < 8; ++f) file[f] = FILE_A << f;
+        for (int f = 0; f < 8; ++f) {
+            adjacentFiles[f] = (f > 0 ? file[f - 1] : 0) | (f < 7 ? file[f + 1] : 0);
+        }
+        for (int c = 0; c < 2; ++c) {
+            for (int sq = 0; sq < 64; ++sq) {
+                int f = sq % 8, r = sq / 8;
+                Bitboard ahead = 0, behind = 0, near = 0;
+                for (int rr = 0; rr < 8; ++rr) {
+                    Bitboard rank = 0xFFULL << (8 * rr);
+                    bool isAhead = (c == 0) ? rr > r : rr < r;
+                    int dist = (c == 0) ? rr - r : r - rr;
+                    if (isAhead) ahead |= rank; else behind |= rank;
+                    if (dist == 1 || dist == 2) near |= rank;
+                }
+                passed[c][sq]  = ahead & (file[f] | adjacentFiles[f]);
+                support[c][sq] = behind & adjacentFiles[f];
+                front[c][sq]   = ahead & file[f];
+                shield[c][sq]  = near & (file[f] | adjacentFiles[f]);
             }
+        }
+    }
+};
+static const PawnMasks pawnMasks;
+
+// Squares attacked by the pawns of one side
+static inline Bitboard pawnAttacks(Bitboard pawns, Color c) {
+    if (c == Color::White) return ((pawns << 7) & ~FILE_H) | ((pawns << 9) & ~FILE_A);
+    return ((pawns >> 9) & ~FILE_H) | ((pawns >> 7) & ~FILE_A);
+}
 
-            score += (val + posVal);
-            // remove the processed bit
-            bbWhite &= (bbWhite - 1);
+// Evaluates the pawn structure, which depends on the pawns only.
+// The result is cached in the calling thread's table, so search threads never share it.
+static const PawnEntry& probePawnStructure(const Board& board, PawnHashTable& pawnHash) {
+    uint64_t key = board.getPawnHash();
+    PawnEntry& entry = pawnHash[key & (PAWN_HASH_SIZE - 1)];
+    if (entry.key == key) return entry; // also covers the pawnless position (key 0)
+
+    entry.key = key;
+    entry.score = 0;
+    for (int c = 0; c < 2; ++c) {
+        Color us = static_cast<Color>(c);
+        Bitboard own   = board.getBitboard(us, PieceType::Pawn);
+        Bitboard enemy = board.getBitboard(opposite(us), PieceType::Pawn);
+        Bitboard enemyAttacks = pawnAttacks(enemy, opposite(us));
+        int sign = (c == 0) ? 1 : -1;
+
+        entry.passed[c] = 0;
+        for (int f = 0; f < 8; ++f) {
+            int count = __builtin_popcountll(own & pawnMasks.file[f]);
+            if (count > 1) entry.score -= sign * DOUBLED_PAWN_PENALTY * (count - 1);
         }
 
-        // --- Black ---
-        Bitboard bbBlack = board.getBitboard(Color::Black, pt);
-        while (bbBlack) {
-            int sq = getLSB(bbBlack);
-            // vertical mirror to use the same tables
-            int tableIdx = sq ^ 56;
-            int posVal = 0;
-
-            switch(pt) {
-            case PieceType::Pawn:        posVal = pawnTable[tableIdx]; break;
-            case PieceType::Knight:      posVal = knightTable[tableIdx]; break;
-            case PieceType::Bishop:      posVal = bishopTable[tableIdx]; break;
-            case PieceType::Rook:        posVal = rookTable[tableIdx]; break;
-            case PieceType::Princess:    posVal = bishopTable[tableIdx]; break;
-            case PieceType::Empress:     posVal = rookTable[tableIdx]; break;
-            case PieceType::Nightrider:  posVal = knightTable[tableIdx]; break;
-            case PieceType::Grasshopper: posVal = knightTable[tableIdx]; break;
-            default: break;
-            }
+        Bitboard bb = own;
+        while (bb) {
+            int sq = getLSB(bb);
+            int f = sq % 8;
+            int relRank = (c == 0) ? sq / 8 : 7 - sq / 8;
 
-            score -= (val + posVal);
-            bbBlack &= (bbBlack - 1);
+            if (!(enemy & pawnMasks.passed[c][sq])) {
+                entry.passed[c] |= (1ULL << sq);
+                entry.score += sign * PASSED_PAWN_BONUS[relRank];
+            }
+            if (!(own & pawnMasks.adjacentFiles[f])) {
+                entry.score -= sign * ISOLATED_PAWN_PENALTY;
+            } else if (!(own & pawnMasks.support[c][sq])) {
+                // No neighbour can come to its defence and its advance square is controlled
+                int stop = (c == 0) ? sq + 8 : sq - 8;
+                if (stop >= 0 && stop < 64 && (enemyAttacks & (1ULL << stop))) {
+                    entry.score -= sign * BACKWARD_PAWN_PENALTY;
+                }
+            }
+            bb &= (bb - 1);
         }
     }
+    return entry;
+}
 
+// Pawn-structure terms: cached structure plus the parts that depend on other pieces
+static Score evaluatePawns(const Board& board, PawnHashTable& pawnHash) {
+    const PawnEntry& entry = probePawnStructure(board, pawnHash);
+    Score score = entry.score;
+    Bitboard occupied = board.getOccupancy();
+
+    for (int c = 0; c < 2; ++c) {
+        Color us = static_cast<Color>(c);
+        int sign = (c == 0) ? 1 : -1;
+
+        // A passed pawn with nothing on its way to promotion is worth half an endgame bonus more
+        Bitboard passed = entry.passed[c];
+        while (passed) {
+            int sq = getLSB(passed);
+            if (!(occupied & pawnMasks.front[c][sq])) {
+                int relRank = (c == 0) ? sq / 8 : 7 - sq / 8;
+                score += sign * makeScore(0, egValue(PASSED_PAWN_BONUS[relRank]) / 2);
+            }
+            passed &= (passed - 1);
+        }
+
+        // Pawn shield in front of a king still on its first two ranks
+        Bitboard king = board.getBitboard(us, PieceType::King);
+        if (king) {
+            int ksq = getLSB(king);
+            int relRank = (c == 0) ? ksq / 8 : 7 - ksq / 8;
+            if (relRank <= 1) {
+                Bitboard shield = board.getBitboard(us, PieceType::Pawn) & pawnMasks.shield[c][ksq];
+                score += sign * PAWN_SHIELD_BONUS * __builtin_popcountll(shield);
+            }
+        }
+    }
     return score;
 }
 
+// Pawn table of direct evaluator calls (tuner, benchmarks), which have no search thread data
+static PawnHashTable& localPawnHash() {
+    static thread_local PawnHashTable pawnHash(PAWN_HASH_SIZE);
+    return pawnHash;
+}
+
+int MaterialAndPositionEvaluation::operator()(const Board& board) const {
+    return evaluateWithPawnHash(board, localPawnHash());
+}
+
+int MaterialAndPositionEvaluation::evaluateWithPawnHash(const Board& board, PawnHashTable& pawnHash) const {
+    // Material and piece-square values are kept up to date by the board on every move
+    Score score = board.getPsqtScore() + evaluatePawns(board, pawnHash);
+    return taperedValue(score, board.getPhase());
+}
+
+void EvaluationFunctions::evaluateBatch(const Board* boards, size_t count, int* scores) const {
+    for (size_t i = 0; i < count; ++i) scores[i] = (*this)(boards[i]);
+}
+
+int EvaluationFunctions::evaluateWithPawnHash(const Board& board, PawnHashTable&) const {
+    return (*this)(board);
+}
+
+void MaterialAndPositionEvaluation::evaluateBatch(const Board* boards, size_t count, int* scores) const {
+    // Gather packed scores and phases by chunks (structure of arrays), then blend them together
+    const size_t CHUNK = 64;
+    Score packed[CHUNK];
+    int phases[CHUNK];
+    PawnHashTable& pawnHash = localPawnHash();
+    for (size_t start = 0; start < count; start += CHUNK) {
+        size_t n = std::min(CHUNK, count - start);
+        for (size_t i = 0; i < n; ++i) {
+            const Board& board = boards[start + i];
+            packed[i] = board.getPsqtScore() + evaluatePawns(board, pawnHash);
+            phases[i] = board.getPhase();
+        }
+        taperedValues(packed, phases, n, scores + start);
+    }
+}
+
+NNUEEvaluation::NNUEEvaluation(const std::string& path) {
+    if (!path.empty() && !nnueLoad(path)) {
+        std::cerr << "NNUE: cannot load " << path << ", using material evaluation" << std::endl;
+    }
+}
+
+int NNUEEvaluation::evaluateWithPawnHash(const Board& board, PawnHashTable& pawnHash) const {
+    if (nnueGeneration() == 0) return fallback.evaluateWithPawnHash(board, pawnHash);
+    return (*this)(board);
+}
+
+int NNUEEvaluation::operator()(const Board& board) const {
+    uint32_t generation = nnueGeneration();
+    if (generation == 0) return fallback(board);
+
+    const Accumulator& acc = board.getAccumulator();
+    if (acc.generation == generation) return nnueOutput(acc);
+
+    // Board created before the network was loaded: compute from scratch
+    Accumulator fresh;
+    nnueRefresh(fresh, board);
+    return nnueOutput(fresh);
+}
+
+
+// TOOLS: SEARCH STATISTICS
+
+SearchStats& SearchStats::operator+=(const SearchStats& other) {
+    nodes += other.nodes;
+    qnodes += other.qnodes;
+    ttProbes += other.ttProbes;
+    ttHits += other.ttHits;
+    ttCutoffs += other.ttCutoffs;
+    betaCutoffs += other.betaCutoffs;
+    firstMoveCutoffs += other.firstMoveCutoffs;
+    rfpPrunes += other.rfpPrunes;
+    nullMoveTries += other.nullMoveTries;
+    nullMoveCutoffs += other.nullMoveCutoffs;
+    iirReductions += other.iirReductions;
+    lmpPrunes += other.lmpPrunes;
+    futilityPrunes += other.futilityPrunes;
+    lmrReductions += other.lmrReductions;
+    lmrResearches += other.lmrResearches;
+    deltaPrunes += other.deltaPrunes;
+    selDepth = std::max(selDepth, other.selDepth);
+    return *this;
+}
+
+double SearchStats::ttHitRate() const {
+    return ttProbes ? static_cast<double>(ttHits) / ttProbes : 0.0;
+}
+
+double SearchStats::firstMoveCutoffRate() const {
+    return betaCutoffs ? static_cast<double>(firstMoveCutoffs) / betaCutoffs : 0.0;
+}
+
+double SearchStats::branchingFactor() const {
+    return iterationNodes[1] ? static_cast<double>(iterationNodes[0]) / iterationNodes[1] : 0.0;
+}
+
+
 
 // TOOLS: TRANSPOSITION TABLE (TT)
 
@@ -153,6 +312,9 @@ void AI::storeTT(uint64_t key, int score, int depth, int alpha, int beta, Move b
     // Simple index in the table
     size_t index = key % ttSize;
 
+    // Quiescence entries (depth 0) must not evict results of the main search
+    if (depth == 0 && transpositionTable[index].depth > 0) return;
+
     // Determines if the score is exact or a bound (fail-low / fail-high)
     TTFlag flag = TTFlag::EXACT;
     if (score <= alpha)      flag = TTFlag::ALPHA; // high bound
@@ -194,69 +356,346 @@ bool AI::probeTT(uint64_t key, int depth, int alpha, int beta, int& score, Move&
     return false;
 }
 
+bool AI::probeTTMove(uint64_t key, Move& bestMove) {
+    std::lock_guard<std::mutex> lock(ttMutex);
+    if (ttSize == 0) return false; // no search yet
+
+    const TTEntry& entry = transpositionTable[key % ttSize];
+    if (entry.key != key || entry.bestMove.from == -1) return false;
+
+    bestMove = entry.bestMove;
+    return true;
+}
+
+std::vector<Move> AI::extractPV(const Board& root, Color turn, int maxLength) {
+    std::vector<Move> pv;
+    std::vector<uint64_t> visited;
+    Board board = root;
+    while (static_cast<int>(pv.size()) < maxLength) {
+        uint64_t key = positionKey(board, turn);
+        if (std::find(visited.begin(), visited.end(), key) != visited.end()) break; // cycle
+        visited.push_back(key);
+
+        Move stored(-1, -1);
+        if (!probeTTMove(key, stored)) break;
+        // The TT may hold a colliding entry: only follow a legal move
+        bool legal = false;
+        for (const auto& m : board.generateLegalMoves(turn)) {
+            if (m.from == stored.from && m.to == stored.to && m.promotion == stored.promotion) {
+                legal = true;
+                break;
+            }
+        }
+        if (!legal) break;
+
+        pv.push_back(stored);
+        board.movePiece(stored.from, stored.to, stored.promotion);
+        turn = opposite(turn);
+    }
+    return pv;
+}
+
 
 // 4) NEGAMAX + ALPHA-BETA + QUIESCENCE
 
-int AI::negamax(const Board& board, int depth, int alpha, int beta, int colorMultiplier) {
+// A move with its ordering (or search) score
+struct ScoredMove {
+    Move move;
+    int score;
+};
+
+// Reverse futility / futility / late move pruning only apply up to these remaining depths
+const int RFP_MAX_DEPTH = 6;
+const int FUTILITY_MAX_DEPTH = 3;
+const int LMP_MAX_DEPTH = 4;
+
+// Internal iterative reduction applies from this remaining depth on
+const int IIR_MIN_DEPTH = 4;
+
+// Null-move pruning is tried from this remaining depth on
+const int NULL_MOVE_MIN_DEPTH = 3;
+// From this depth on, a null-move cutoff is confirmed by a reduced normal search
+const int NULL_MOVE_VERIFY_DEPTH = 10;
+
+// Late move reductions apply from this remaining depth / move number on
+const int LMR_MIN_DEPTH = 3;
+const int LMR_MIN_MOVES = 3;
+
+// Late move reduction table, indexed by [remaining depth][move number]
+// The later the move in the ordering and the deeper the node, the larger the reduction
+struct ReductionTable {
+    int r[MAX_DEPTH + 1][64];
+    ReductionTable() {
+        for (int d = 0; d <= MAX_DEPTH; ++d) {
+            for (int m = 0; m < 64; ++m) {
+                r[d][m] = (d == 0 || m == 0) ? 0 : (int)(0.75 + std::log(d) * std::log(m) / 2.25);
+            }
+        }
+    }
+};
+static const ReductionTable lmrTable;
+
+// Null-move zugzwang guard: does the side own pieces other than king and pawns?
+// Grasshoppers are left out: they need a hurdle to move, so a side left with
+// grasshoppers only is as zugzwang-prone as a pawn ending.
+static bool hasNonPawnMaterial(const Board& board, Color c) {
+    return (board.getBitboard(c, PieceType::Knight) | board.getBitboard(c, PieceType::Bishop)
+          | board.getBitboard(c, PieceType::Rook)   | board.getBitboard(c, PieceType::Queen)
+          | board.getBitboard(c, PieceType::Princess) | board.getBitboard(c, PieceType::Empress)
+          | board.getBitboard(c, PieceType::Nightrider)) != 0;
+}
+
+// Ordering score of a move (higher is searched first)
+// The hash move is not scored: it is searched before generation
+const int CAPTURE_SCORE     = 500000;
+const int PROMOTION_SCORE   = 400000;
+const int KILLER_SCORE      = 300000; // first slot, the second one gets 1 less
+const int COUNTERMOVE_SCORE = 290000;
+
+// Capture flag of a move read back from the TT (en passant lands on an empty square)
+static bool isCaptureOn(const Board& board, const Move& m) {
+    if (board.isSquareOccupied(m.to)) return true;
+    Color c;
+    return m.to == board.getEnPassantTarget() && board.getPieceTypeAt(m.from, c) == PieceType::Pawn;
+}
+
+// History gravity: the bonus shrinks as the entry approaches HISTORY_MAX,
+// so scores stay bounded and old information fades out
+static void updateHistory(int& entry, int bonus) {
+    entry += bonus - entry * std::abs(bonus) / HISTORY_MAX;
+}
+
+int AI::negamax(ThreadData& td, const Board& board, int depth, int ply, int alpha, int beta, int colorMultiplier,
+                bool allowNull) {
+    // Stop: switch to quiescence to avoid the horizon effect (it probes the TT itself)
+    if (depth <= 0 || ply >= MAX_DEPTH) return quiescence(td, board, ply, alpha, beta, colorMultiplier);
+
+    // 0) Stop polling: the score of an aborted search is never used
+    if ((++td.nodes & 1023) == 0) checkLimits();
+    if (stopRequested) return 0;
+    if (ply > td.stats.selDepth) td.stats.selDepth = ply;
+
     int alphaOrig = alpha;
 
     // 1) Hash of the position
-    uint64_t hash = board.getHash();
-    if (colorMultiplier == -1) {
-        // Simple trick to distinguish sides if necessary
-        hash = ~hash;
-    }
+    uint64_t hash = positionKey(board, (colorMultiplier == 1) ? Color::White : Color::Black);
+
+    // MultiPV lines after the first search a reduced root: its result must neither
+    // come from nor go to the root entry, which belongs to the full move list
+    bool excluding = (ply == 0 && !td.rootExcluded.empty());
 
     // 2) Attempt in the transposition table
     int ttScore;
-    Move ttMove(0,0);
-    if (probeTT(hash, depth, alpha, beta, ttScore, ttMove)) {
+    Move ttMove;
+    SEARCH_STAT(td, ttProbes);
+    if (probeTT(hash, depth, alpha, beta, ttScore, ttMove) && !excluding) {
+        SEARCH_STAT(td, ttHits);
+        SEARCH_STAT(td, ttCutoffs);
         return ttScore;
     }
-
-    // Stop: switch to quiescence to avoid the horizon effect
-    if (depth == 0) return quiescence(board, alpha, beta, colorMultiplier);
+    if (ttMove.from >= 0) SEARCH_STAT(td, ttHits);
 
     Color turn = (colorMultiplier == 1) ? Color::White : Color::Black;
-    std::vector<Move> moves = board.generateLegalMoves(turn);
+    int side = static_cast<int>(turn);
+
+    // The stored move may come from a colliding position: validate it without generating
+    bool hasTTMove = ttMove.from >= 0 && board.isPseudoLegal(ttMove, turn);
+    if (hasTTMove) ttMove.isCapture = isCaptureOn(board, ttMove);
 
-    // No moves: checkmate or stalemate
-    if (moves.empty()) {
-        if (board.isInCheck(turn)) return -MATE_VALUE - depth; // prefers quick mates
-        return 0;
+    // Internal iterative reduction: without a hash move the ordering is poor,
+    // so this node is searched one ply shallower (the next iteration fills the TT)
+    if (!hasTTMove && depth >= IIR_MIN_DEPTH) {
+        --depth;
+        SEARCH_STAT(td, iirReductions);
+    }
+    bool inCheck = board.isInCheck(turn);
+    bool pvNode = (beta - alpha > 1);
+    // Forward pruning is only sound away from mate scores and never in check
+    bool canPrune = !pvNode && !inCheck && std::abs(alpha) < MATE_VALUE && std::abs(beta) < MATE_VALUE;
+    int staticEval = inCheck ? -INF : colorMultiplier * evaluateCached(td, board);
+
+    // 3) Reverse futility pruning: near the leaves, a static eval far above
+    // beta is very unlikely to be refuted
+    if (canPrune && depth <= RFP_MAX_DEPTH && staticEval - params.rfpMargin * depth >= beta) {
+        SEARCH_STAT(td, rfpPrunes);
+        return staticEval;
     }
 
-    // 3) Sorting moves: we try the TT move first, then captures/promotions
-    auto moveSorter = [&](const Move& a, const Move& b) {
-        if (ttMove.from != 0) {
-            if (a.from == ttMove.from && a.to == ttMove.to) return true;
-            if (b.from == ttMove.from && b.to == ttMove.to) return false;
+    // 4) Null-move pruning: let the opponent play twice; if a reduced search
+    // still fails high, a real move would too. Unsafe in check and in
+    // zugzwang-prone positions (king and pawns only)
+    if (allowNull && canPrune && depth >= NULL_MOVE_MIN_DEPTH
+        && hasNonPawnMaterial(board, turn) && staticEval >= beta) {
+        int R = 2 + depth / 4; // deeper nodes afford a larger reduction
+        Board nullBoard = board;
+        nullBoard.makeNullMove();
+        td.moveStack[ply] = Move();
+        SEARCH_STAT(td, nullMoveTries);
+        int nullScore = -negamax(td, nullBoard, std::max(depth - 1 - R, 0), ply + 1, -beta, -beta + 1, -colorMultiplier, false);
+        if (stopRequested) return 0;
+
+        if (nullScore >= beta) {
+            if (nullScore >= MATE_VALUE) nullScore = beta; // a mate found by passing is not proven
+            if (depth < NULL_MOVE_VERIFY_DEPTH) {
+                SEARCH_STAT(td, nullMoveCutoffs);
+                return nullScore;
+            }
+
+            // Deep node: verify with a reduced search that cannot null-move again
+            int verified = negamax(td, board, depth - 1 - R, ply, beta - 1, beta, colorMultiplier, false);
+            if (stopRequested) return 0;
+            if (verified >= beta) {
+                SEARCH_STAT(td, nullMoveCutoffs);
+                return nullScore;
+            }
         }
-        if (a.isCapture != b.isCapture) return a.isCapture;
-        if (a.promotion != PieceType::None) return true;
-        return false;
-    };
-    std::sort(moves.begin(), moves.end(), moveSorter);
+    }
+
+    // 5) Move loop. The hash move is searched before any generation: when it
+    // cuts, the node never pays for generateLegalMoves
+    const Move& killer1 = td.killers[ply][0];
+    const Move& killer2 = td.killers[ply][1];
+    Move prevMove = (ply > 0) ? td.moveStack[ply - 1] : Move();
+    Move counterMove = (prevMove.from >= 0) ? td.counterMoves[prevMove.from][prevMove.to] : Move();
 
     int maxScore = -INF;
-    Move bestMoveFound(0,0);
+    Move bestMoveFound;
+    int moveCount = 0;
+    std::vector<Move> quietsTried;
+
+    // Searches one legal move; returns true on a beta cutoff
+    auto searchMove = [&](const Move& move, const Board& nextBoard) {
+        if (excluding && std::find(td.rootExcluded.begin(), td.rootExcluded.end(), move) != td.rootExcluded.end()) {
+            return false;
+        }
+        bool quiet = !move.isCapture && move.promotion == PieceType::None;
+        bool killer = (move == killer1 || move == killer2);
+        bool givesCheck = nextBoard.isInCheck(opposite(turn));
+
+        // Quiet move pruning near the leaves, once a real score is secured
+        if (canPrune && quiet && !killer && !givesCheck && moveCount > 0 && maxScore > -MATE_VALUE) {
+            // Late move pruning: late quiet moves at shallow depth are skipped
+            if (depth <= LMP_MAX_DEPTH && moveCount >= params.lmpBase + depth * depth) {
+                SEARCH_STAT(td, lmpPrunes);
+                return false;
+            }
+            // Futility pruning: a quiet move cannot recover that much material
+            if (depth <= FUTILITY_MAX_DEPTH && staticEval + params.futilityMargin * depth <= alpha) {
+                SEARCH_STAT(td, futilityPrunes);
+                return false;
+            }
+        }
 
-    for (const auto& move : moves) {
-        Board nextBoard = board;
-        nextBoard.movePiece(move.from, move.to, move.promotion);
+        td.moveStack[ply] = move;
+
+        // Principal Variation Search: the first (best ordered) move gets the full
+        // window, the others only have to prove they are not better than alpha
+        int score;
+        if (moveCount == 0) {
+            score = -negamax(td, nextBoard, depth - 1, ply + 1, -beta, -alpha, -colorMultiplier);
+        } else {
+            // Late move reductions: quiet moves far down the ordering rarely
+            // raise alpha, so they are first searched shallower
+            int reduction = 0;
+            if (depth >= LMR_MIN_DEPTH && moveCount >= LMR_MIN_MOVES && !inCheck
+                && quiet && !killer && !givesCheck) {
+                reduction = lmrTable.r[std::min(depth, MAX_DEPTH)][std::min(moveCount, 63)];
+                if (pvNode && reduction > 0) reduction--;
+                reduction = std::min(reduction, depth - 2); // always leave at least one ply
+            }
 
-        int score = -negamax(nextBoard, depth - 1, -beta, -alpha, -colorMultiplier);
+            if (reduction > 0) SEARCH_STAT(td, lmrReductions);
+            score = -negamax(td, nextBoard, depth - 1 - reduction, ply + 1, -alpha - 1, -alpha, -colorMultiplier);
+            // The reduced search beat alpha: confirm at full depth
+            if (reduction > 0 && score > alpha) {
+                SEARCH_STAT(td, lmrResearches);
+                score = -negamax(td, nextBoard, depth - 1, ply + 1, -alpha - 1, -alpha, -colorMultiplier);
+            }
+            // The null window failed high: re-search to get the exact score
+            if (score > alpha && score < beta) {
+                score = -negamax(td, nextBoard, depth - 1, ply + 1, -beta, -alpha, -colorMultiplier);
+            }
+        }
+        ++moveCount;
+        if (stopRequested) return true;
 
         if (score > maxScore) {
             maxScore = score;
             bestMoveFound = move;
         }
         if (score > alpha) alpha = score;
-        if (alpha >= beta) break; // alpha-beta cutoff
+        if (alpha >= beta) {
+            SEARCH_STAT(td, betaCutoffs);
+            if (moveCount == 1) SEARCH_STAT(td, firstMoveCutoffs);
+            // Quiet cutoff move: remember it for the ordering of sibling / later nodes
+            if (quiet) {
+                if (!(move == killer1)) {
+                    td.killers[ply][1] = td.killers[ply][0];
+                    td.killers[ply][0] = move;
+                }
+                int bonus = std::min(depth * depth, 400);
+                updateHistory(td.history[side][move.from][move.to], bonus);
+                for (const auto& q : quietsTried) {
+                    updateHistory(td.history[side][q.from][q.to], -bonus);
+                }
+                if (prevMove.from >= 0) td.counterMoves[prevMove.from][prevMove.to] = move;
+            }
+            return true;
+        }
+        if (quiet) quietsTried.push_back(move);
+        return false;
+    };
+
+    bool cutoff = false;
+    if (hasTTMove) {
+        Board nextBoard = board;
+        nextBoard.movePiece(ttMove.from, ttMove.to, ttMove.promotion);
+        if (nextBoard.isInCheck(turn)) {
+            hasTTMove = false; // pseudo-legal only: leaves our king in check
+        } else {
+            cutoff = searchMove(ttMove, nextBoard);
+        }
     }
 
-    // 4) Saving in the TT
-    storeTT(hash, maxScore, depth, alphaOrig, beta, bestMoveFound);
+    if (!cutoff) {
+        std::vector<Move> moves = board.generateLegalMoves(turn);
+
+        // No moves: checkmate or stalemate
+        if (moves.empty()) {
+            if (inCheck) return -MATE_VALUE - depth; // prefers quick mates
+            return 0;
+        }
+
+        // Ordering: captures, promotions, then quiet moves by killer / countermove / history
+        auto moveScore = [&](const Move& m) {
+            if (m.isCapture) return CAPTURE_SCORE + (m.promotion != PieceType::None ? 1 : 0);
+            if (m.promotion != PieceType::None) return PROMOTION_SCORE;
+            if (m == killer1) return KILLER_SCORE;
+            if (m == killer2) return KILLER_SCORE - 1;
+            if (m == counterMove) return COUNTERMOVE_SCORE;
+            return td.history[side][m.from][m.to];
+        };
+        std::vector<ScoredMove> ordered;
+        ordered.reserve(moves.size());
+        for (const auto& m : moves) {
+            if (hasTTMove && m == ttMove) continue; // already searched
+            ordered.push_back({m, moveScore(m)});
+        }
+        std::stable_sort(ordered.begin(), ordered.end(), [](const ScoredMove& x, const ScoredMove& y) {
+            return x.score > y.score;
+        });
+
+        for (const auto& entry : ordered) {
+            Board nextBoard = board;
+            nextBoard.movePiece(entry.move.from, entry.move.to, entry.move.promotion);
+            if (searchMove(entry.move, nextBoard)) break;
+        }
+    }
+    if (stopRequested) return 0;
+
+    // 6) Saving in the TT
+    if (ply == 0) td.rootBestMove = bestMoveFound;
+    if (!excluding) storeTT(hash, maxScore, depth, alphaOrig, beta, bestMoveFound);
 
     return maxScore;
 }
@@ -264,31 +703,270 @@ int AI::negamax(const Board& board, int depth, int alpha, int beta, int colorMul
 
 // 5) Search from roots (Lazy SMP)
 
-Move AI::getBestMove(const Board& board, Color turn) {
+// Half-width of the first aspiration window (centipawns), doubled on each fail
+const int ASPIRATION_WINDOW = 50;
+// Iterations shallower than this use the full window (scores are still unstable)
+const int ASPIRATION_MIN_DEPTH = 4;
+
+Move AI::getBestMove(const Board& board, Color turn, const SearchLimits& limits) {
+    // Resize the table before the clock starts: a large allocation must not eat the move's time
+    allocateHash();
+    prepareSearch(limits);
+    return search(board, turn, limits);
+}
+
+void AI::startSearch(const Board& board, Color turn, const SearchLimits& limits,
+                     std::function<void(Move)> onDone) {
+    waitForSearch();
+    allocateHash(); // before the clock starts, see getBestMove()
+    // Reset here, in the caller's thread, so that a stop() sent right after
+    // this call cannot be overwritten by the search thread starting up
+    prepareSearch(limits);
+    searchThread = std::thread([this, board, turn, limits, onDone]() {
+        Move best = search(board, turn, limits);
+        if (onDone) onDone(best);
+    });
+}
+
+void AI::waitForSearch() {
+    if (searchThread.joinable()) searchThread.join();
+}
+
+void AI::setTimeLimit(int64_t ms) {
+    deadline = (ms > 0) ? nowMs() + ms : 0;
+}
+
+void AI::prepareSearch(const SearchLimits& limits) {
+    stopRequested = false;
+    setTimeLimit(limits.moveTimeMs);
+    nodesSearched = 0;
+    nodeLimit = limits.nodes;
+}
+
+void AI::checkLimits() {
+    int64_t d = deadline;
+    if (d != 0 && nowMs() >= d) stopRequested = true;
+    int64_t searched = (nodesSearched += 1024);
+    int64_t budget = nodeLimit;
+    if (budget != 0 && searched >= budget) stopRequested = true;
+}
+
+void AI::setHashSize(size_t mb) {
+    ttRequestedSize = static_cast<int>(std::max<size_t>(1, mb * 1024 * 1024 / sizeof(TTEntry)));
+}
+
+int AI::activeThreadCount() const {
+    int threads = (numThreads > 0) ? numThreads : static_cast<int>(std::thread::hardware_concurrency());
+    return std::max(1, threads);
+}
+
+void AI::allocateHash() {
+    // Pawn tables follow the thread count; the ones kept still hold valid entries
+    pawnTables.resize(activeThreadCount());
+    for (auto& table : pawnTables) {
+        if (table.size() != PAWN_HASH_SIZE) table.assign(PAWN_HASH_SIZE, PawnEntry());
+    }
+
+    if (ttSize == ttRequestedSize) return;
+    // Release the old table first, so that both never coexist in memory
+    std::vector<TTEntry>().swap(transpositionTable);
+    transpositionTable.resize(ttRequestedSize);
+    ttSize = ttRequestedSize;
+}
+
+void AI::collectStats(ThreadData& td) {
+    td.stats.nodes = td.nodes;
+    std::lock_guard<std::mutex> lock(statsMutex);
+    stats += td.stats;
+    stats.timeMs = nowMs() - searchStartMs;
+}
+
+int AI::hashFull() {
+    std::lock_guard<std::mutex> lock(ttMutex);
+    int sample = std::min(ttSize, 1000);
+    int used = 0;
+    for (int i = 0; i < sample; ++i) {
+        if (transpositionTable[i].key != 0) ++used;
+    }
+    return sample ? used * 1000 / sample : 0;
+}
+
+SearchStats AI::lastSearchStats() const {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return stats;
+}
+
+void AI::clearHash() {
+    int threads = std::min(activeThreadCount(), ttSize / 65536 + 1); // small tables: not worth a thread
+    size_t slice = (static_cast<size_t>(ttSize) + threads - 1) / threads;
+
+    auto clearSlice = [this, slice](int i) {
+        size_t begin = std::min(slice * i, transpositionTable.size());
+        size_t end = std::min(begin + slice, transpositionTable.size());
+        std::fill(transpositionTable.begin() + begin, transpositionTable.begin() + end, TTEntry());
+    };
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threads; ++i) workers.emplace_back(clearSlice, i);
+    clearSlice(0);
+    for (auto& t : workers) t.join();
+}
+
+bool AI::getPonderMove(const Board& board, Color turn, const Move& best, Move& ponder) {
+    if (best.from < 0 || best.from == best.to) return false;
+
+    Board nextBoard = board;
+    nextBoard.movePiece(best.from, best.to, best.promotion);
+
+    Move stored(-1, -1);
+    if (!probeTTMove(positionKey(nextBoard, opposite(turn)), stored)) return false;
+
+    // The TT may hold a colliding entry: only trust a legal move
+    for (const auto& m : nextBoard.generateLegalMoves(opposite(turn))) {
+        if (m.from == stored.from && m.to == stored.to && m.promotion == stored.promotion) {
+            ponder = m;
+            return true;
+        }
+    }
+    return false;
+}
+
+SearchInfo AI::makeSearchInfo(const Board& board, Color turn, const ThreadData& td, int depth, const Move& rootMove,
+                              int score, int rank, int64_t startMs) {
+    SearchInfo info;
+    info.depth = depth;
+    info.selDepth = td.stats.selDepth;
+    info.score = score;
+    info.nodes = nodesSearched + (td.nodes & 1023);
+    info.timeMs = nowMs() - startMs;
+    info.hashFull = hashFull();
+    info.multiPv = rank;
+    // The root entry only holds the best line: the rest is read after the line's own move
+    Board child = board;
+    child.movePiece(rootMove.from, rootMove.to, rootMove.promotion);
+    info.pv.push_back(rootMove);
+    for (const auto& m : extractPV(child, opposite(turn), depth - 1)) info.pv.push_back(m);
+
+    // Mate scores hold the remaining depth of the mated node, not its distance:
+    // count the plies when the PV ends in mate, estimate them otherwise
+    if (std::abs(score) > MATE_VALUE) {
+        Board end = board;
+        Color side = turn;
+        for (const auto& m : info.pv) {
+            end.movePiece(m.from, m.to, m.promotion);
+            side = opposite(side);
+        }
+        int plies = std::max(1, depth - (std::abs(score) - MATE_VALUE));
+        if (end.isInCheck(side) && !end.hasAnyLegalMove(side)) plies = static_cast<int>(info.pv.size());
+        info.mateIn = (score > 0) ? (plies + 1) / 2 : -((plies + 1) / 2);
+    }
+    return info;
+}
+
+Move AI::search(const Board& position, Color turn, const SearchLimits& limits) {
    //1. Configuration
+   // Root copy whose NNUE accumulator matches the loaded network, so moves update it incrementally
+   Board board = position;
+   board.refreshAccumulator();
    int colorMultiplier = (turn == Color::White) ? 1 : -1;
-   uint64_t rootHash = board.getHash();
-   if (turn  == Color::Black) {rootHash = ~rootHash;}
+   uint64_t rootHash = positionKey(board, turn);
+   // Without an explicit depth, timed / node-limited / infinite searches deepen until stopped
+   int maxDepth = limits.depth;
+   if (maxDepth <= 0) {
+       bool limited = limits.infinite || limits.moveTimeMs > 0 || limits.nodes > 0;
+       maxDepth = limited ? MAX_DEPTH : searchDepth;
+   }
+   if (maxDepth > MAX_DEPTH) maxDepth = MAX_DEPTH;
    // Limitation on the number of threads
-   int numThreads = std::thread::hardware_concurrency();
-   if (numThreads < 1) numThreads = 1;
+   int threadCount = std::min(activeThreadCount(), static_cast<int>(pawnTables.size()));
+
+   // MultiPV: never more lines than root moves
+   int lineCount = std::max(1, std::min(multiPv, static_cast<int>(board.generateLegalMoves(turn).size())));
+
+   // Best move (and score) of the last iteration fully completed by the main thread
+   Move completedBest(-1, -1);
+   int completedScore = 0;
+   int64_t startMs = nowMs();
+   {
+       std::lock_guard<std::mutex> lock(statsMutex);
+       stats = SearchStats();
+       searchStartMs = startMs;
+   }
+   // Main-thread node counts at the end of the last three completed iterations
+   uint64_t iterationEnd[3] = {};
+   int completedDepth = 0;
 
    // vector to store tasks
    std::vector<std::future<void>> futures;
    //2. DDefinition of a thread's task
    auto searchWorker = [&](int threadID) {
+    ThreadData td;
+    td.id = threadID;
+    td.pawnHash = &pawnTables[threadID];
     // Each thread has its own copy of the board
     Board threadBoard = board;
     // Iterative deepening
     // Allows the thread to perform a partial search to fill the TT
     // which allows other threads to prune more effectively
-    for (int depth = 1; depth <= searchDepth; ++depth) {
-        negamax(threadBoard, depth, -INF, INF, colorMultiplier);
+    // Score of each line in the previous iteration (aspiration window centers)
+    std::vector<int> prevScores(lineCount, 0);
+    for (int depth = 1; depth <= maxDepth; ++depth) {
+        // Root lines of this iteration, each one excluding the best moves of the previous ones
+        std::vector<ScoredMove> lines;
+        td.rootExcluded.clear();
+        for (int pvIndex = 0; pvIndex < lineCount; ++pvIndex) {
+            int& prevScore = prevScores[pvIndex];
+            // Aspiration window around the previous iteration's score
+            int delta = ASPIRATION_WINDOW;
+            int alpha = -INF, beta = INF;
+            if (depth >= ASPIRATION_MIN_DEPTH) {
+                alpha = std::max(prevScore - delta, -INF);
+                beta  = std::min(prevScore + delta, INF);
+            }
+            while (true) {
+                int score = negamax(td, threadBoard, depth, 0, alpha, beta, colorMultiplier);
+                if (stopRequested) break;
+                // Fail low / fail high: widen the failing side and search again
+                if (score <= alpha)     alpha = std::max(score - delta, -INF);
+                else if (score >= beta) beta  = std::min(score + delta, INF);
+                else { prevScore = score; break; }
+                delta *= 2;
+            }
+            if (stopRequested) break;
+            // The first line may end on a root TT cutoff, the others never touch the root entry
+            Move m = td.rootBestMove;
+            if (pvIndex == 0 && !probeTTMove(rootHash, m)) m = Move(-1, -1);
+            if (m.from < 0) break;
+            lines.push_back({m, prevScore});
+            td.rootExcluded.push_back(m);
+        }
+        if (stopRequested) break;
+        if (threadID == 0) {
+            // A later line can outscore an earlier one (different windows): rank them
+            // once, so that the played move is always the one reported as multipv 1
+            std::stable_sort(lines.begin(), lines.end(), [](const ScoredMove& a, const ScoredMove& b) {
+                return a.score > b.score;
+            });
+            if (!lines.empty()) {
+                completedBest = lines[0].move;
+                completedScore = lines[0].score;
+            }
+            completedDepth = depth;
+            iterationEnd[2] = iterationEnd[1];
+            iterationEnd[1] = iterationEnd[0];
+            iterationEnd[0] = td.nodes;
+            if (infoCallback) {
+                for (size_t i = 0; i < lines.size(); ++i) {
+                    infoCallback(makeSearchInfo(board, turn, td, depth, lines[i].move, lines[i].score,
+                                                static_cast<int>(i) + 1, startMs));
+                }
+            }
+        }
     }
+    collectStats(td);
     };
    //3. Launching secondary threads
    // We launch (N-1) threads, the main thread also performs a search
-   for(int i = 1; i < numThreads;i++){
+   for(int i = 1; i < threadCount;i++){
         futures.push_back(std::async(std::launch::async, searchWorker, i));
    }
    //4. Main search in the main thread
@@ -297,28 +975,53 @@ Move AI::getBestMove(const Board& board, Color turn) {
    for(auto& f : futures){
         f.get();
    }
+   {
+       std::lock_guard<std::mutex> lock(statsMutex);
+       stats.depth = completedDepth;
+       stats.iterationNodes[0] = iterationEnd[0] - iterationEnd[1];
+       stats.iterationNodes[1] = iterationEnd[1] - iterationEnd[2];
+   }
    //6. Retrieving move scores from the TT
    std::vector<Move> moves = board.generateLegalMoves(turn);
    if (moves.empty()) {
        return Move(0,0); // No legal moves
    }
-   struct ScoredMove {
-         Move move;
-         int score;
+   // Interrupted search (stop or time out): play the last completed iteration's move
+   auto completedMove = [&]() {
+       lastScore = completedScore;
+       for (const auto& m : moves) {
+           if (m.from == completedBest.from && m.to == completedBest.to && m.promotion == completedBest.promotion) return m;
+       }
+       return moves[0];
    };
-   std::vector<std::future<ScoredMove>> scoreFutures;
-   for (const auto& move : moves) {
-    scoreFutures.push_back(std::async(std::launch::async, [=, &board]() -> ScoredMove {
+   if (stopRequested || !randomRootChoice || lineCount > 1) return completedMove();
+   // Rescore every root move, with no more workers than search threads (the Threads setting
+   // bounds the engine's footprint): each worker takes the next move not scored yet
+   std::vector<ScoredMove> scoredMoves(moves.size());
+   std::atomic<size_t> nextMove{0};
+   auto scoreWorker = [&](int workerID) {
+    ThreadData td;
+    td.id = workerID;
+    td.pawnHash = &pawnTables[workerID];
+    size_t k;
+    while ((k = nextMove++) < moves.size()) {
         Board nextBoard = board;
-        nextBoard.movePiece(move.from, move.to, move.promotion);
-        int score = -negamax(nextBoard, searchDepth -1, -INF, INF, -colorMultiplier);
-        return {move, score};
-    }));
-    }
-    std::vector<ScoredMove> scoredMoves;
-    for (auto& sf : scoreFutures) {
-        scoredMoves.push_back(sf.get());
+        nextBoard.movePiece(moves[k].from, moves[k].to, moves[k].promotion);
+        int score = -negamax(td, nextBoard, maxDepth -1, 1, -INF, INF, -colorMultiplier);
+        scoredMoves[k] = {moves[k], score};
     }
+    collectStats(td);
+   };
+   std::vector<std::future<void>> scoreFutures;
+   int scoreWorkers = std::min(threadCount, static_cast<int>(moves.size()));
+   for (int i = 1; i < scoreWorkers; ++i) {
+    scoreFutures.push_back(std::async(std::launch::async, scoreWorker, i));
+   }
+   scoreWorker(0);
+   for (auto& sf : scoreFutures) {
+        sf.get();
+   }
+    if (stopRequested) return completedMove();
    //7. Sort moves by descending score
    std::sort(scoredMoves.begin(), scoredMoves.end(), [](const ScoredMove& a, const ScoredMove& b)
     {
@@ -337,11 +1040,13 @@ Move AI::getBestMove(const Board& board, Color turn) {
             static std::mt19937 gen(rd());
             std::uniform_int_distribution<> dis(0, 1);
             if (dis(gen) == 1) {
+                lastScore = scoredMoves[1].score;
                 return scoredMoves[1].move;
             }
         }
 
     }
+    lastScore = scoredMoves[0].score;
     return scoredMoves[0].move;
 }
 
@@ -351,9 +1056,36 @@ Move AI::getBestMove(const Board& board, Color turn) {
 // ==========================================
 // 6. QUIESCENCE SEARCH (From Dev)
 // ==========================================
-int AI::quiescence(const Board& board, int alpha, int beta, int colorMultiplier) {
+int AI::evaluateCached(ThreadData& td, const Board& board) {
+    uint64_t key = board.getHash();
+    EvalCacheEntry& entry = td.evalCache[key & (EVAL_CACHE_SIZE - 1)];
+    if (entry.key != key) {
+        entry.key = key;
+        entry.score = td.pawnHash ? evaluate->evaluateWithPawnHash(board, *td.pawnHash) : (*evaluate)(board);
+    }
+    return entry.score;
+}
+
+int AI::quiescence(ThreadData& td, const Board& board, int ply, int alpha, int beta, int colorMultiplier) {
+    if ((++td.nodes & 1023) == 0) checkLimits();
+    if (stopRequested) return 0;
+    SEARCH_STAT(td, qnodes);
+    if (ply > td.stats.selDepth) td.stats.selDepth = ply;
+
+    int alphaOrig = alpha;
+    Color turn = (colorMultiplier == 1) ? Color::White : Color::Black;
+
+    // 0. Transposition table: capture sequences transpose a lot
+    uint64_t hash = positionKey(board, turn);
+    int ttScore;
+    Move ttMove;
+    if (probeTT(hash, 0, alpha, beta, ttScore, ttMove)) {
+        return ttScore;
+    }
+
     // 1. Stand Pat
-    int stand_pat = colorMultiplier * (*evaluate)(board);
+    // (stand-pat cutoffs are not stored: the evaluation cache already makes them cheap)
+    int stand_pat = colorMultiplier * evaluateCached(td, board);
 
     if (stand_pat >= beta) return beta;
 
@@ -364,24 +1096,61 @@ int AI::quiescence(const Board& board, int alpha, int beta, int colorMultiplier)
 
     if (stand_pat > alpha) alpha = stand_pat;
 
-    Color turn = (colorMultiplier == 1) ? Color::White : Color::Black;
     // We generate only capture moves for quiescence search
     std::vector<Move> moves = board.generateCaptures(turn); 
 
-    std::sort(moves.begin(), moves.end(), [](const Move& a, const Move& b) {
-        if (a.promotion != PieceType::None && b.promotion == PieceType::None) return true;
-        if (a.promotion == PieceType::None && b.promotion != PieceType::None) return false;
-        return false;
+    // MVV-LVA: most valuable victim first, then least valuable attacker.
+    // Promotions add the promoted piece to the gain, so they come first.
+    struct CaptureMove {
+        Move move;
+        int score; ///< Ordering key.
+        int gain;  ///< Material won (victim + promotion bonus).
+    };
+    std::vector<CaptureMove> captures;
+    captures.reserve(moves.size());
+    for (const auto& m : moves) {
+        Color c;
+        PieceType attacker = board.getPieceTypeAt(m.from, c);
+        PieceType victim   = board.getPieceTypeAt(m.to, c);
+        if (victim == PieceType::None) victim = PieceType::Pawn; // en passant
+
+        int gain = pieceValues[static_cast<int>(victim)];
+        if (m.promotion != PieceType::None) gain += pieceValues[static_cast<int>(m.promotion)] - pieceValues[0];
+        int score = gain * 256 - pieceValues[static_cast<int>(attacker)] / 16;
+        if (m == ttMove) score = INF * 256; // hash move first
+        captures.push_back({m, score, gain});
+    }
+    std::sort(captures.begin(), captures.end(), [](const CaptureMove& a, const CaptureMove& b) {
+        return a.score > b.score;
     });
 
-    for (const auto& move : moves) {
+    const int DELTA_MARGIN = 200; // positional slack for a single capture
+    Move bestMove;
+    for (const auto& capture : captures) {
+        const Move& move = capture.move;
+
+        // Per-capture delta pruning: even winning this victim for free
+        // would not bring the score back to alpha
+        if (stand_pat + capture.gain + DELTA_MARGIN <= alpha) {
+            SEARCH_STAT(td, deltaPrunes);
+            continue;
+        }
+
         Board nextBoard = board;
         nextBoard.movePiece(move.from, move.to, move.promotion);
 
-        int score = -quiescence(nextBoard, -beta, -alpha, -colorMultiplier);
+        int score = -quiescence(td, nextBoard, ply + 1, -beta, -alpha, -colorMultiplier);
+        if (stopRequested) return 0;
 
-        if (score >= beta) return beta;
-        if (score > alpha) alpha = score;
+        if (score >= beta) {
+            storeTT(hash, beta, 0, alphaOrig, beta, move);
+            return beta;
+        }
+        if (score > alpha) {
+            alpha = score;
+            bestMove = move;
+        }
     }
+    storeTT(hash, alpha, 0, alphaOrig, beta, bestMove);
     return alpha;
 }
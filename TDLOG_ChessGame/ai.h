@@ -6,7 +6,11 @@
 #include "player.h"
 
 #include <mutex>   ///< Thread-safety for the transposition table.
+#include <atomic>
+#include <thread>
+#include <functional>
 #include <vector>
+#include <string>
 #include <cstdint>
 
 /**
@@ -72,6 +76,164 @@ const int INF = 50000;
  */
 const int MATE_VALUE = 49000;
 
+/** @brief Default transposition table size (megabytes). */
+const size_t DEFAULT_HASH_MB = 64;
+
+/** @brief Hard cap on the iterative deepening depth (plies). */
+const int MAX_DEPTH = 64;
+
+/**
+ * @brief Limits applied to one search.
+ *
+ * A zero value means "not set". When neither a depth nor a time budget is
+ * given (and the search is not infinite), the AI's default depth is used.
+ */
+struct SearchLimits {
+    int depth = 0;          ///< Maximum depth in plies (0 = AI default, or MAX_DEPTH when timed/infinite).
+    int64_t moveTimeMs = 0; ///< Time budget in milliseconds (0 = no time limit).
+    bool infinite = false;  ///< Search until stop() is called (UCI "go infinite" / "go ponder").
+    int64_t nodes = 0;      ///< Node budget shared by all search threads (0 = unlimited).
+};
+
+/**
+ * @brief Tunable forward-pruning parameters (exposed as UCI options).
+ */
+struct SearchParams {
+    int rfpMargin = 80;       ///< Reverse futility margin per ply of remaining depth (cp).
+    int futilityMargin = 120; ///< Futility margin per ply of remaining depth (cp).
+    int lmpBase = 3;          ///< Late move pruning: quiet moves allowed = lmpBase + depth^2.
+};
+
+/**
+ * @brief Counters of one search, summed over all search threads.
+ *
+ * @ref nodes, @ref selDepth, @ref depth, @ref iterationNodes and @ref timeMs are always
+ * filled. The other counters are compiled out (and stay at zero) when the engine is built
+ * with TDLOG_NO_SEARCH_STATS.
+ */
+struct SearchStats {
+    uint64_t nodes = 0;            ///< Nodes visited (main search and quiescence).
+    uint64_t qnodes = 0;           ///< Quiescence nodes.
+    uint64_t ttProbes = 0;         ///< Transposition table probes of the main search.
+    uint64_t ttHits = 0;           ///< Probes that found an entry for the position.
+    uint64_t ttCutoffs = 0;        ///< Probes whose stored score ended the node.
+    uint64_t betaCutoffs = 0;      ///< Nodes that failed high in the move loop.
+    uint64_t firstMoveCutoffs = 0; ///< Fail highs on the first move searched.
+    uint64_t rfpPrunes = 0;        ///< Nodes cut by reverse futility pruning.
+    uint64_t nullMoveTries = 0;    ///< Null-move searches.
+    uint64_t nullMoveCutoffs = 0;  ///< Nodes cut by null-move pruning.
+    uint64_t iirReductions = 0;    ///< Nodes searched one ply shallower for lack of a hash move.
+    uint64_t lmpPrunes = 0;        ///< Quiet moves skipped by late move pruning.
+    uint64_t futilityPrunes = 0;   ///< Quiet moves skipped by futility pruning.
+    uint64_t lmrReductions = 0;    ///< Moves searched with a late move reduction.
+    uint64_t lmrResearches = 0;    ///< Reduced searches repeated at full depth.
+    uint64_t deltaPrunes = 0;      ///< Captures skipped by delta pruning in quiescence.
+    int depth = 0;                 ///< Last iteration completed by the main thread.
+    int selDepth = 0;              ///< Deepest ply reached, quiescence included.
+    uint64_t iterationNodes[2] = {}; ///< Main-thread nodes of the last two completed iterations ([0] = last).
+    int64_t timeMs = 0;            ///< Time from the start of the search to the last thread finishing (ms).
+
+    /**
+     * @brief Add the counters of another thread (@ref selDepth takes the maximum).
+     *
+     * @ref depth, @ref iterationNodes and @ref timeMs describe the whole search and are not merged.
+     *
+     * @param other Counters to add.
+     * @return This object.
+     */
+    SearchStats& operator+=(const SearchStats& other);
+
+    /** @brief Share of TT probes that found their position (0 to 1). */
+    double ttHitRate() const;
+
+    /** @brief Share of fail highs produced by the first move searched (0 to 1). */
+    double firstMoveCutoffRate() const;
+
+    /** @brief Effective branching factor: nodes of the last iteration over the previous one. */
+    double branchingFactor() const;
+};
+
+/**
+ * @brief Progress report of the search, sent after each completed iteration (UCI "info").
+ */
+struct SearchInfo {
+    int depth = 0;        ///< Depth of the completed iteration.
+    int selDepth = 0;     ///< Deepest ply reached by the main thread.
+    int score = 0;        ///< Score in centipawns, from the side to move's point of view.
+    int mateIn = 0;       ///< Moves until mate for a mate score (negative when getting mated), else 0.
+    uint64_t nodes = 0;   ///< Nodes searched so far (helper threads are counted by blocks of 1024).
+    int64_t timeMs = 0;   ///< Time since the search started.
+    int hashFull = 0;     ///< Transposition table occupancy, in permille.
+    int multiPv = 1;      ///< Rank of this line among the root moves (1 = best).
+    std::vector<Move> pv; ///< Principal variation, read from the transposition table.
+};
+
+/** @brief Number of entries of the per-thread evaluation cache (power of two). */
+const int EVAL_CACHE_SIZE = 1 << 14;
+
+/**
+ * @brief One slot of the evaluation cache: static eval of a position (White's point of view).
+ */
+struct EvalCacheEntry {
+    uint64_t key = 0; ///< Board hash (Board::getHash()).
+    int score = 0;    ///< Cached evaluation.
+};
+
+/** @brief Number of entries of a pawn-structure hash table (power of two). */
+const size_t PAWN_HASH_SIZE = 1 << 14;
+
+/**
+ * @brief Cached pawn-structure score (packed, White's perspective) and passed pawns of each side.
+ */
+struct PawnEntry {
+    uint64_t key = 0;              ///< Pawn hash (Board::getPawnHash()).
+    Score score = 0;               ///< Structure terms, packed MG/EG.
+    Bitboard passed[2] = {0, 0};   ///< Passed pawns of White and Black.
+};
+
+/** @brief Pawn-structure hash table owned by one search thread. */
+using PawnHashTable = std::vector<PawnEntry>;
+
+/** @brief Bound of the history scores (the gravity update keeps them within +/- this value). */
+const int HISTORY_MAX = 16384;
+
+/**
+ * @brief Per-thread search state.
+ *
+ * Each Lazy SMP worker owns one instance, so nothing in here needs locking.
+ * The move ordering tables live here and persist across the iterations
+ * of one search.
+ */
+struct ThreadData {
+    int id = 0;         ///< Worker index (0 = main thread).
+    uint64_t nodes = 0; ///< Nodes visited by this worker.
+    SearchStats stats;  ///< Counters of this worker (nodes are copied in when it finishes).
+
+    /** @brief Two quiet moves per ply that recently caused a beta cutoff. */
+    Move killers[MAX_DEPTH + 1][2];
+
+    /** @brief Butterfly history [side][from][to]: how often a quiet move caused a cutoff. */
+    int history[2][64][64] = {};
+
+    /** @brief Quiet move that refuted each opponent move, indexed by [from][to] of that move. */
+    Move counterMoves[64][64];
+
+    /** @brief Root moves skipped by the current search (best moves of the previous MultiPV lines). */
+    std::vector<Move> rootExcluded;
+
+    /** @brief Best move of the last root search (set even when the root TT entry is not stored). */
+    Move rootBestMove;
+
+    /** @brief Move played at each ply of the current line (invalid for a null move). */
+    Move moveStack[MAX_DEPTH + 1];
+
+    /** @brief Small direct-mapped cache of static evaluations (heap allocated). */
+    std::vector<EvalCacheEntry> evalCache = std::vector<EvalCacheEntry>(EVAL_CACHE_SIZE);
+
+    /** @brief Pawn table of this worker, kept by the AI across searches (null: evaluator's own). */
+    PawnHashTable* pawnHash = nullptr;
+};
+
 /**
  * @brief Interface for evaluation strategies.
  *
@@ -88,13 +250,41 @@ public:
      * @return Evaluation score from White's perspective (positive = White is better).
      */
     virtual int operator()(const Board& board) const = 0;
+
+    /**
+     * @brief Evaluate many positions at once (tuning, data generation).
+     *
+     * The default calls operator() on each board; evaluators may provide a vectorized path.
+     *
+     * @param boards Positions to evaluate.
+     * @param count Number of positions.
+     * @param scores Output: one score per position, from White's perspective.
+     */
+    virtual void evaluateBatch(const Board* boards, size_t count, int* scores) const;
+
+    /**
+     * @brief Evaluate a position, caching pawn-structure terms in the caller's table.
+     *
+     * Used by the search, whose pawn tables outlive its threads. The default
+     * ignores the table and calls operator().
+     *
+     * @param board Current board position.
+     * @param pawnHash Pawn-structure table of the calling thread.
+     * @return Evaluation score from White's perspective.
+     */
+    virtual int evaluateWithPawnHash(const Board& board, PawnHashTable& pawnHash) const;
 };
 
 /**
  * @brief Default evaluation based on material and piece-square tables.
  *
- * Combines material values and positional bonuses (piece-square tables).
+ * Combines material values and positional bonuses (piece-square tables), each with a
+ * middlegame and an endgame value blended by the game phase (tapered evaluation).
+ * Both are maintained incrementally by the board (Board::getPsqtScore(), Board::getPhase()).
  * Designed to support both standard and fairy pieces (depending on your PieceType set).
+ * Pawn-structure terms (passed, isolated, doubled and backward pawns) are cached in a
+ * pawn hash table indexed by Board::getPawnHash(): the search thread's own table (see
+ * evaluateWithPawnHash()), or a thread-local one for direct calls.
  */
 class MaterialAndPositionEvaluation : public EvaluationFunctions {
 public:
@@ -104,6 +294,57 @@ public:
      * @return Evaluation score from White's perspective.
      */
     int operator()(const Board& board) const override;
+
+    /**
+     * @brief Evaluate many positions, blending their MG/EG scores with SIMD.
+     * @param boards Positions to evaluate.
+     * @param count Number of positions.
+     * @param scores Output: one score per position, from White's perspective.
+     */
+    void evaluateBatch(const Board* boards, size_t count, int* scores) const override;
+
+    /**
+     * @brief Evaluate a position with the pawn-structure terms cached in @p pawnHash.
+     * @param board Current board position.
+     * @param pawnHash Pawn-structure table of the calling thread.
+     * @return Evaluation score from White's perspective.
+     */
+    int evaluateWithPawnHash(const Board& board, PawnHashTable& pawnHash) const override;
+};
+
+/**
+ * @brief Evaluation by a small efficiently updatable neural network (NNUE).
+ *
+ * Reads the accumulator the board keeps up to date on every move and runs the output
+ * layer (see nnue.h). Positions whose accumulator was built for another network are
+ * refreshed on the fly. Falls back to @ref MaterialAndPositionEvaluation while no network
+ * is loaded.
+ */
+class NNUEEvaluation : public EvaluationFunctions {
+public:
+    /**
+     * @brief Create the evaluator, optionally loading a weight file.
+     * @param path Weight file passed to nnueLoad() (empty: keep the current network, if any).
+     */
+    explicit NNUEEvaluation(const std::string& path = "");
+
+    /**
+     * @brief Evaluate a position with the active network.
+     * @param board Current board position.
+     * @return Evaluation score from White's perspective.
+     */
+    int operator()(const Board& board) const override;
+
+    /**
+     * @brief Same as operator(), the fallback evaluation using the caller's pawn table.
+     * @param board Current board position.
+     * @param pawnHash Pawn-structure table of the calling thread.
+     * @return Evaluation score from White's perspective.
+     */
+    int evaluateWithPawnHash(const Board& board, PawnHashTable& pawnHash) const override;
+
+private:
+    MaterialAndPositionEvaluation fallback;
 };
 
 /**
@@ -123,15 +364,63 @@ class AI : public Player {
     /** @brief Maximum search depth (plies). */
     int searchDepth;
 
-    /** @brief Fixed-size transposition table storage. */
+    /** @brief Forward-pruning margins. */
+    SearchParams params;
+
+    /** @brief Fixed-size transposition table storage (allocated when a search starts). */
     std::vector<TTEntry> transpositionTable;
 
-    /** @brief Number of entries in @ref transpositionTable. */
+    /** @brief Number of entries in @ref transpositionTable (0 until the first search). */
     int ttSize = 0;
 
+    /** @brief Number of entries asked for by setHashSize(), applied by allocateHash(). */
+    int ttRequestedSize = 0;
+
+    /** @brief One pawn-structure table per search thread, kept across searches (see allocateHash()). */
+    std::vector<PawnHashTable> pawnTables;
+
     /** @brief Mutex to protect TT accesses during multi-threaded search. */
     std::mutex ttMutex;
 
+    /** @brief Set by stop() or when the time budget runs out; polled by the search. */
+    std::atomic<bool> stopRequested{false};
+
+    /** @brief Absolute deadline in steady-clock milliseconds (0 = none). */
+    std::atomic<int64_t> deadline{0};
+
+    /** @brief Node budget of the running search (0 = none). */
+    std::atomic<int64_t> nodeLimit{0};
+
+    /** @brief Nodes searched so far by all threads, counted by blocks of 1024. */
+    std::atomic<int64_t> nodesSearched{0};
+
+    /** @brief Number of search threads (0 = one per hardware thread). */
+    int numThreads = 0;
+
+    /** @brief Number of root lines searched and reported (MultiPV). */
+    int multiPv = 1;
+
+    /** @brief Score of the last search, from the side to move's point of view. */
+    int lastScore = 0;
+
+    /** @brief Counters of the last search (threads add theirs when they finish). */
+    SearchStats stats;
+
+    /** @brief Protects @ref stats and @ref searchStartMs. */
+    mutable std::mutex statsMutex;
+
+    /** @brief Steady-clock start of the last search (milliseconds). */
+    int64_t searchStartMs = 0;
+
+    /** @brief Pick randomly between two close root moves (see search()). */
+    bool randomRootChoice = true;
+
+    /** @brief Called by the main search thread after each completed iteration. */
+    std::function<void(const SearchInfo&)> infoCallback;
+
+    /** @brief Background thread used by startSearch(). */
+    std::thread searchThread;
+
 public:
     /**
      * @brief Construct an AI with a given evaluation strategy and search depth.
@@ -140,8 +429,7 @@ public:
      */
     AI(EvaluationFunctions* evalStrategy, int depth)
         : evaluate(evalStrategy), searchDepth(depth) {
-        ttSize = 2000000;
-        transpositionTable.resize(ttSize);
+        setHashSize(DEFAULT_HASH_MB);
     }
 
     /**
@@ -150,6 +438,8 @@ public:
      * Deletes the owned evaluation strategy.
      */
     ~AI() {
+        stop();
+        waitForSearch();
         if (evaluate) delete evaluate;
     }
 
@@ -164,22 +454,194 @@ public:
      * @brief Compute the best move from a given board position.
      * @param board Current board position.
      * @param turn Side to play.
+     * @param limits Depth / time limits (defaults to the AI's search depth).
      * @return Best move found by the search.
      */
-    Move getBestMove(const Board& board, Color turn);
+    Move getBestMove(const Board& board, Color turn, const SearchLimits& limits = SearchLimits());
+
+    /**
+     * @brief Start a search on a background thread and return immediately.
+     *
+     * When the search ends (limit reached or stop()), @p onDone is called from
+     * the search thread with the best move found. Any previous search is
+     * waited for first.
+     *
+     * @param board Root position (copied).
+     * @param turn Side to play.
+     * @param limits Depth / time limits.
+     * @param onDone Callback receiving the best move.
+     */
+    void startSearch(const Board& board, Color turn, const SearchLimits& limits,
+                     std::function<void(Move)> onDone);
+
+    /**
+     * @brief Ask the running search to stop as soon as possible.
+     *
+     * Thread-safe. The search then returns the best move of the last
+     * completed iteration.
+     */
+    void stop() { stopRequested = true; }
+
+    /**
+     * @brief Block until the background search (and its callback) has finished.
+     */
+    void waitForSearch();
+
+    /**
+     * @brief Set (or reset) the time budget of the running search, counted from now.
+     *
+     * Used on UCI "ponderhit", where the clock only starts once the predicted
+     * move has actually been played.
+     *
+     * @param ms Time budget in milliseconds (0 = no time limit).
+     */
+    void setTimeLimit(int64_t ms);
+
+    /**
+     * @brief Access the forward-pruning parameters (set them between searches).
+     * @return Mutable reference to the parameters.
+     */
+    SearchParams& searchParams() { return params; }
+
+    /**
+     * @brief Set the number of search threads (between searches).
+     * @param n Thread count (0 = one per hardware thread).
+     */
+    void setThreads(int n) { numThreads = (n < 0) ? 0 : n; }
+
+    /**
+     * @brief Set the number of root lines searched and reported (between searches).
+     *
+     * Line k is searched with the best moves of lines 1..k-1 excluded from the root.
+     * With more than one line, the best line's move is always played (no random choice).
+     *
+     * @param n Number of lines (at least 1).
+     */
+    void setMultiPV(int n) { multiPv = (n < 1) ? 1 : n; }
+
+    /**
+     * @brief Set the transposition table size (between searches).
+     *
+     * The memory is only (re)allocated when the next search starts, before its
+     * time limit is armed; the content is then lost.
+     *
+     * @param mb Size in megabytes.
+     */
+    void setHashSize(size_t mb);
+
+    /**
+     * @brief Empty the transposition table (between searches).
+     *
+     * The table is split into one slice per search thread, cleared concurrently.
+     */
+    void clearHash();
+
+    /**
+     * @brief Enable or disable the random choice between close root moves.
+     *
+     * When disabled, the search returns the best move of its last completed
+     * iteration and skips the full-width rescoring of the root moves, so that a
+     * single-threaded fixed-depth search is reproducible (see the bench command).
+     *
+     * @param enabled True to keep the random choice (default).
+     */
+    void setRandomRootChoice(bool enabled) { randomRootChoice = enabled; }
+
+    /**
+     * @brief Score of the last completed search.
+     * @return Centipawns from the point of view of the side that was to move.
+     */
+    int lastSearchScore() const { return lastScore; }
+
+    /**
+     * @brief Number of nodes visited by the last completed search.
+     * @return Exact node count, summed over all search threads.
+     */
+    uint64_t lastSearchNodes() const { return lastSearchStats().nodes; }
+
+    /**
+     * @brief Counters of the last completed search.
+     * @return Copy of the statistics, summed over all search threads.
+     */
+    SearchStats lastSearchStats() const;
+
+    /**
+     * @brief Receive a progress report after each completed iteration (set between searches).
+     *
+     * The callback runs on the main search thread, so it should return quickly.
+     *
+     * @param callback Function receiving the report (empty to disable).
+     */
+    void setInfoCallback(std::function<void(const SearchInfo&)> callback) { infoCallback = std::move(callback); }
+
+    /**
+     * @brief Estimate the transposition table occupancy from its first 1000 entries.
+     * @return Used entries in permille (UCI "hashfull").
+     */
+    int hashFull();
+
+    /**
+     * @brief Read the expected reply to @p best from the transposition table.
+     * @param board Root position of the last search.
+     * @param turn Side to play at the root.
+     * @param best Move returned by the search.
+     * @param ponder Output: expected opponent reply.
+     * @return True if a legal reply was found.
+     */
+    bool getPonderMove(const Board& board, Color turn, const Move& best, Move& ponder);
 
 private:
+    /** @brief Lets the chess_bench microbenchmarks time storeTT() / probeTT() directly. */
+    friend struct TTBenchAccess;
+
+    /**
+     * @brief Iterative deepening driver shared by getBestMove() and startSearch().
+     *
+     * Does not reset the stop flag, so that a stop() issued right after
+     * startSearch() is never lost.
+     */
+    Move search(const Board& board, Color turn, const SearchLimits& limits);
+
+    /**
+     * @brief Apply the size requested by setHashSize() if it differs from the current table.
+     *
+     * Also sizes @ref pawnTables to the number of search threads. Called by
+     * getBestMove() and startSearch() before prepareSearch(), so that the
+     * allocation is not counted in the search's time budget.
+     */
+    void allocateHash();
+
+    /** @brief Number of search threads: the Threads setting, or the hardware threads when 0. */
+    int activeThreadCount() const;
+
+    /**
+     * @brief Reset the stop flag and arm the time and node limits of a new search.
+     * @param limits Limits of the search about to start.
+     */
+    void prepareSearch(const SearchLimits& limits);
+
+    /**
+     * @brief Raise the stop flag if the deadline has passed or the node budget is spent.
+     *
+     * Called every 1024 nodes by each search thread.
+     */
+    void checkLimits();
+
     /**
      * @brief Negamax search with alpha-beta pruning.
      *
+     * @param td Per-thread search state.
      * @param board Current position.
      * @param depth Remaining depth (plies).
+     * @param ply Distance from the root (plies).
      * @param alpha Alpha bound.
      * @param beta Beta bound.
      * @param colorMultiplier +1 for White to move, -1 for Black to move.
+     * @param allowNull False right after a null move (no two null moves in a row).
      * @return Best score for the side to move (after applying @p colorMultiplier).
      */
-    int negamax(const Board& board, int depth, int alpha, int beta, int colorMultiplier);
+    int negamax(ThreadData& td, const Board& board, int depth, int ply, int alpha, int beta, int colorMultiplier,
+                bool allowNull = true);
 
     /**
      * @brief Quiescence search to reduce the horizon effect.
@@ -187,19 +649,36 @@ private:
      * Typically explores only tactical moves (captures, sometimes checks/promotions),
      * starting from a "stand pat" evaluation.
      *
+     * @param td Per-thread search state.
      * @param board Current position.
+     * @param ply Distance from the root (plies).
      * @param alpha Alpha bound.
      * @param beta Beta bound.
      * @param colorMultiplier +1 for White to move, -1 for Black to move.
      * @return Refined evaluation score.
      */
-    int quiescence(const Board& board, int alpha, int beta, int colorMultiplier);
+    int quiescence(ThreadData& td, const Board& board, int ply, int alpha, int beta, int colorMultiplier);
+
+    /**
+     * @brief Add a finished worker's counters to @ref stats (thread-safe).
+     * @param td State of the worker.
+     */
+    void collectStats(ThreadData& td);
+
+    /**
+     * @brief Static evaluation through the thread's evaluation cache.
+     * @param td Per-thread search state (owns the cache).
+     * @param board Position to evaluate.
+     * @return Evaluation from White's perspective, as returned by the strategy.
+     */
+    int evaluateCached(ThreadData& td, const Board& board);
 
     /**
      * @brief Store a result in the transposition table.
      *
      * The entry flag (EXACT/ALPHA/BETA) is determined based on the returned score
-     * relative to the original alpha/beta window.
+     * relative to the original alpha/beta window. Quiescence results are stored
+     * at depth 0 and never replace an entry of the main search.
      *
      * @param key Position hash key.
      * @param score Score to store.
@@ -226,4 +705,40 @@ private:
      * @return True if the entry provides a usable score for the current window.
      */
     bool probeTT(uint64_t key, int depth, int alpha, int beta, int& score, Move& bestMove);
+
+    /**
+     * @brief Read only the stored best move of a position, whatever its depth.
+     * @param key Position hash key.
+     * @param bestMove Output: stored best move.
+     * @return True if an entry with a valid move exists for @p key.
+     */
+    bool probeTTMove(uint64_t key, Move& bestMove);
+
+    /**
+     * @brief Follow the stored best moves from a position.
+     *
+     * Stops at the first missing or illegal (colliding) entry, and before a position
+     * repeats, so that a cycle of entries cannot produce an endless line.
+     *
+     * @param board Root position.
+     * @param turn Side to play at the root.
+     * @param maxLength Maximum number of moves.
+     * @return Principal variation.
+     */
+    std::vector<Move> extractPV(const Board& board, Color turn, int maxLength);
+
+    /**
+     * @brief Build the report of one line of an iteration completed by the main thread.
+     * @param board Root position.
+     * @param turn Side to play at the root.
+     * @param td Main thread state.
+     * @param depth Completed depth.
+     * @param rootMove First move of the line.
+     * @param score Score of the line (side to move's point of view).
+     * @param rank Rank of the line (1 = best).
+     * @param startMs Steady-clock start of the search.
+     * @return Report passed to the info callback.
+     */
+    SearchInfo makeSearchInfo(const Board& board, Color turn, const ThreadData& td, int depth, const Move& rootMove,
+                              int score, int rank, int64_t startMs);
 };
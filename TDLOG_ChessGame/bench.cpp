@@ -0,0 +1,125 @@
+#include "bench.h"
+#include "ai.h"
+#include "game.h"
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// --- POSITION SUITE ---
+
+// Each position is reached by playing the first plies of a game from the initial position
+struct SuiteEntry {
+    const char* name;
+    Variant variant;
+    const char* moves;
+    int plies;
+};
+
+static const char* const sicilianGame =
+    "e2e4 c7c5 g1f3 d7d6 d2d4 c5d4 f3d4 g8f6 b1c3 a7a6 f1d3 e7e5 d4f3 d8b6 d1e2 c8e6 "
+    "a2a4 b8c6 e1g1 e8c8 e2e3 b6b4 h2h3 d6d5 c3d5 e6d5 c2c3 b4c5 e4d5 c5d5 d3e2 d5d6 "
+    "f3g5 d6e7 e2c4 h8g8 a4a5 f6d5 e3f3 e7c5 c4d3 d8d7 d3h7 g8h8 h7f5 f7f6 g5e4 c5c4 "
+    "f3g4 c8d8 f5d7 d8c7 e4f6 c4f1 g1f1 d5f6 g4e6 f6d7 c1e3 f8e7";
+
+static const char* const queensGambitGame =
+    "d2d4 g8f6 c2c4 e7e6 g1f3 d7d5 b1c3 f8e7 c1f4 b8c6 e2e3 e8g8 f3e5 e7b4 d1c2 c8d7 "
+    "f1d3 c6e5 d4e5 b4c3 c2c3 f6e4 d3e4 d5e4 c4c5 d7b5 c3d4 d8e7 a1c1 a8e8 a2a3 a7a5 "
+    "h2h3 h7h6 a3a4 b5d3 d4c3 e8a8 e1d2 a8d8 h1g1 d3b5 d2c2 b5a4 c2b1 g7g5 f4h2 d8a8 "
+    "h2g3 a4b5 c3b3 b5c6 b3c4 f8d8 g1e1 a5a4 c4b4 h6h5 g3h2 e7d7 c1c3 d7d2 c3c4 a4a3 "
+    "b4d2 d8d2 b2a3 a8a3 h2g1 c6d5 c4b4 h5h4 b4b2 d2b2 b1b2 a3b3 b2c1 b3c3 c1d2 c3c4 "
+    "e1c1 c4c1 d2c1 b7b6 c1b2 b6c5 b2c3 g8f8 g1h2 c7c6 g2g3 h4g3 h2g3 c5c4 c3c2 c6c5";
+
+static const char* const fairyOpenGame =
+    "e2e4 e7e5 g1a4 f8g6 f1e3 c8d6 c1d3 g8a5 c2c4 b7b5 a4e2 b8e2 e3e2 a5b7 d1b3 d6c4 "
+    "e2c3 g6d6 e1e2 b7d3 b3c2 d3c5 c3c4 b5c4 b1a3 d6d4 e2f1 d4c2 a3c2 c5a1 c2a1 d8h4";
+
+static const char* const fairyClosedGame =
+    "d2d4 d7d5 c2c4 e7e6 f1g3 g7g6 c4d5 e6d5 c1f4 b8h5 g3e3 c8e6 f4e6 f8e6 b1d5 h5b2 "
+    "d1c1 e6e3 d5e3 g8e7 e3c7 e8f8 g1f3 b2d6 e1g1 a8c8 c1h6 f8g8 f3d2 f7f6 c7e6 d6f5 "
+    "d2f6 g8f7 e6d8 h8d8 h6h7 f7f6 a1d1 f5d1 h7h4 f6f7 f1d1 e7d5 a2a3 d8e8 h4g5 d5c3";
+
+static const SuiteEntry benchSuite[] = {
+    { "classic-start",           Variant::Classic,    "",               0 },
+    { "classic-sicilian",        Variant::Classic,    sicilianGame,     10 },
+    { "classic-sicilian-middle", Variant::Classic,    sicilianGame,     30 },
+    { "classic-sicilian-late",   Variant::Classic,    sicilianGame,     60 },
+    { "classic-qgd",             Variant::Classic,    queensGambitGame, 8 },
+    { "classic-qgd-middle",      Variant::Classic,    queensGambitGame, 40 },
+    { "classic-qgd-late",        Variant::Classic,    queensGambitGame, 84 },
+    { "classic-bishop-endgame",  Variant::Classic,    queensGambitGame, 96 },
+    { "fairy-start",             Variant::FairyChess, "",               0 },
+    { "fairy-open",              Variant::FairyChess, fairyOpenGame,    12 },
+    { "fairy-open-middle",       Variant::FairyChess, fairyOpenGame,    32 },
+    { "fairy-closed",            Variant::FairyChess, fairyClosedGame,  16 },
+    { "fairy-closed-middle",     Variant::FairyChess, fairyClosedGame,  48 },
+};
+
+static int squareIndex(const std::string& s, size_t at) {
+    return (s[at + 1] - '1') * 8 + (s[at] - 'a');
+}
+
+// Plays the first plies of the entry's game; false if a move is not legal
+static bool setUp(const SuiteEntry& entry, Game& game) {
+    game.startGame(entry.variant);
+    std::istringstream iss(entry.moves);
+    std::string token;
+    for (int ply = 0; ply < entry.plies; ++ply) {
+        if (!(iss >> token) || token.size() < 4) return false;
+        if (!game.playMove(Move(squareIndex(token, 0), squareIndex(token, 2)))) return false;
+    }
+    return true;
+}
+
+std::vector<BenchPosition> benchPositions() {
+    std::vector<BenchPosition> positions;
+    for (const auto& entry : benchSuite) {
+        Game game;
+        if (!setUp(entry, game)) {
+            std::cerr << "bench: cannot set up " << entry.name << std::endl;
+            continue;
+        }
+        positions.push_back({ entry.name, entry.variant, game.board(), game.currentTurn() });
+    }
+    return positions;
+}
+
+// --- RUN ---
+
+uint64_t runBench(const BenchConfig& config, std::ostream& out) {
+    AI ai(new MaterialAndPositionEvaluation(), config.depth);
+    ai.setThreads(config.threads);
+    ai.setHashSize(config.hashMb);
+    ai.setRandomRootChoice(false);
+
+    SearchLimits limits;
+    limits.depth = config.depth;
+
+    uint64_t totalNodes = 0;
+    int64_t totalMs = 0;
+    out << "{\n  \"depth\": " << config.depth << ",\n  \"threads\": " << config.threads
+        << ",\n  \"positions\": [\n";
+
+    bool first = true;
+    for (const auto& position : benchPositions()) {
+        ai.clearHash();
+
+        auto start = std::chrono::steady_clock::now();
+        ai.getBestMove(position.board, position.turn, limits);
+        int64_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        uint64_t nodes = ai.lastSearchNodes();
+        totalNodes += nodes;
+        totalMs += ms;
+
+        out << (first ? "" : ",\n") << "    { \"name\": \"" << position.name << "\", \"nodes\": " << nodes
+            << ", \"time_ms\": " << ms << ", \"score\": " << ai.lastSearchScore() << " }";
+        first = false;
+    }
+
+    uint64_t nps = totalNodes * 1000 / static_cast<uint64_t>(totalMs > 0 ? totalMs : 1);
+    out << "\n  ],\n  \"nodes\": " << totalNodes << ",\n  \"time_ms\": " << totalMs
+        << ",\n  \"nps\": " << nps << "\n}" << std::endl;
+    return totalNodes;
+}
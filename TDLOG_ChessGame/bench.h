@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "board.h"
+
+/**
+ * @brief Settings of a benchmark run.
+ */
+struct BenchConfig {
+    int depth = 9;      ///< Fixed search depth of every position.
+    int threads = 1;    ///< Search threads (node counts are only reproducible with 1).
+    size_t hashMb = 16; ///< Transposition table size, cleared before each position.
+};
+
+/**
+ * @brief A position of the built-in benchmark suite.
+ */
+struct BenchPosition {
+    std::string name; ///< Short identifier (variant and game phase).
+    Variant variant;  ///< Variant the position belongs to.
+    Board board;      ///< Piece placement, castling and en passant state.
+    Color turn;       ///< Side to move.
+};
+
+/**
+ * @brief Build the positions of the benchmark suite.
+ *
+ * Shared by @ref runBench and the chess_bench microbenchmarks.
+ *
+ * @return Classic and FairyChess positions from the opening to the endgame.
+ */
+std::vector<BenchPosition> benchPositions();
+
+/**
+ * @brief Search a built-in suite of Classic and FairyChess positions to a fixed depth.
+ *
+ * The random root choice is disabled and the transposition table is cleared before
+ * each position, so that a single-threaded run always visits the same number of
+ * nodes: the total acts as a signature of the search and evaluation behaviour.
+ * The report (per-position and total nodes, time and nodes per second) is written
+ * as one JSON object.
+ *
+ * @param config Run settings.
+ * @param out Stream receiving the JSON report.
+ * @return Total number of nodes searched.
+ */
+uint64_t runBench(const BenchConfig& config, std::ostream& out);
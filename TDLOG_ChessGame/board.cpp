@@ -3,6 +3,9 @@
 #include <cmath>   // for std::abs
 #include <vector>
 #include <random> // for Zobrist hashing
+#include <cctype>
+#include <sstream>
+#include <mutex>  // std::call_once for the static tables
 
 // --- ZOBRIST KEYS (Static) ---
 // We store random numbers for [Color][Piece][Square]
@@ -10,11 +13,12 @@ static uint64_t zPieceKeys[2][10][64];
 static uint64_t zEnPassantKeys[65]; // 64 squares + 1 (none)
 static uint64_t zCastleKeys[16];    // 4 rights (bitmask 0-15)
 static uint64_t zSideKey;           // For the turn (Black)
-// Flag to check if initialized
-static bool zInitialized = false;
+// Filled once, even when the first boards are created by several threads at once
+static std::once_flag zInitialized;
 
 Board::Board(Variant v) {
     initZobristKeys();
+    initPsqt();
     // 1. Reset everything to 0
     std::memset(bitboards_, 0, sizeof(bitboards_));
     std::memset(occupancies_, 0, sizeof(occupancies_));
@@ -88,6 +92,10 @@ Board::Board(Variant v) {
 
     enPassantTarget_ = -1;
     zobristKey_ = calculateHash();
+    pawnKey_ = calculatePawnHash();
+    psqtScore_ = calculatePsqtScore();
+    phase_ = calculatePhase();
+    nnueRefresh(accumulator_, *this);
 }
 
 // =======================
@@ -119,6 +127,22 @@ PieceType Board::getPieceTypeAt(int square, Color& color) const {
     return PieceType::None;
 }
 
+void Board::putPiece(Color c, PieceType pt, int square) {
+    setBit(bitboards_[static_cast<int>(c)][static_cast<int>(pt)], square);
+    psqtScore_ += psqtTable[static_cast<int>(c)][static_cast<int>(pt)][square];
+    phase_ += phaseWeights[static_cast<int>(pt)];
+    if (pt == PieceType::Pawn) pawnKey_ ^= zPieceKeys[static_cast<int>(c)][static_cast<int>(pt)][square];
+    if (accumulator_.generation != 0) nnueAddFeature(accumulator_, c, pt, square);
+}
+
+void Board::removePiece(Color c, PieceType pt, int square) {
+    popBit(bitboards_[static_cast<int>(c)][static_cast<int>(pt)], square);
+    psqtScore_ -= psqtTable[static_cast<int>(c)][static_cast<int>(pt)][square];
+    phase_ -= phaseWeights[static_cast<int>(pt)];
+    if (pt == PieceType::Pawn) pawnKey_ ^= zPieceKeys[static_cast<int>(c)][static_cast<int>(pt)][square];
+    if (accumulator_.generation != 0) nnueRemoveFeature(accumulator_, c, pt, square);
+}
+
 void Board::movePiece(int from, int to, PieceType promotion) {
     Color color;
     PieceType pt = getPieceTypeAt(from, color);
@@ -130,7 +154,7 @@ void Board::movePiece(int from, int to, PieceType promotion) {
     // 2. Handle En Passant capture (remove the pawn behind)
     if (isEnPassant) {
         int capturedSq = (color == Color::White) ? to - 8 : to + 8;
-        popBit(bitboards_[static_cast<int>(opposite(color))][static_cast<int>(PieceType::Pawn)], capturedSq);
+        removePiece(opposite(color), PieceType::Pawn, capturedSq);
     }
 
     // 3. Handle castling rights on king/rook moves
@@ -153,7 +177,7 @@ void Board::movePiece(int from, int to, PieceType promotion) {
             // Friendly capture should never happen on a legal move; fail-safe early return.
             return;
         }
-        popBit(bitboards_[static_cast<int>(targetColor)][static_cast<int>(targetPt)], to);
+        removePiece(targetColor, targetPt, to);
 
         // Capturing a rook may remove castling rights
         if (targetPt == PieceType::Rook) {
@@ -166,10 +190,10 @@ void Board::movePiece(int from, int to, PieceType promotion) {
 
     // 5. Handle rook move in castling (king move of two squares)
     if (pt == PieceType::King && std::abs(to - from) == 2) {
-        if (color == Color::White && to == 6) { popBit(bitboards_[0][3], 7);  setBit(bitboards_[0][3], 5); }
-        if (color == Color::White && to == 2) { popBit(bitboards_[0][3], 0);  setBit(bitboards_[0][3], 3); }
-        if (color == Color::Black && to == 62){ popBit(bitboards_[1][3], 63); setBit(bitboards_[1][3], 61); }
-        if (color == Color::Black && to == 58){ popBit(bitboards_[1][3], 56); setBit(bitboards_[1][3], 59); }
+        if (color == Color::White && to == 6) { removePiece(color, PieceType::Rook, 7);  putPiece(color, PieceType::Rook, 5); }
+        if (color == Color::White && to == 2) { removePiece(color, PieceType::Rook, 0);  putPiece(color, PieceType::Rook, 3); }
+        if (color == Color::Black && to == 62){ removePiece(color, PieceType::Rook, 63); putPiece(color, PieceType::Rook, 61); }
+        if (color == Color::Black && to == 58){ removePiece(color, PieceType::Rook, 56); putPiece(color, PieceType::Rook, 59); }
     }
 
     // 6. Update en-passant target (only valid one ply)
@@ -180,17 +204,149 @@ void Board::movePiece(int from, int to, PieceType promotion) {
     enPassantTarget_ = nextEnPassantTarget;
 
     // 7. Move the piece (with optional promotion)
-    popBit(bitboards_[static_cast<int>(color)][static_cast<int>(pt)], from);
-    if (promotion != PieceType::None) {
-        setBit(bitboards_[static_cast<int>(color)][static_cast<int>(promotion)], to);
-    } else {
-        setBit(bitboards_[static_cast<int>(color)][static_cast<int>(pt)], to);
+    removePiece(color, pt, from);
+    putPiece(color, (promotion != PieceType::None) ? promotion : pt, to);
+
+    updateOccupancies();
+    zobristKey_ = calculateHash();
+}
+
+void Board::makeNullMove() {
+    if (enPassantTarget_ != -1) {
+        zobristKey_ ^= zEnPassantKeys[enPassantTarget_];
+        enPassantTarget_ = -1;
     }
+}
+
+void Board::clear() {
+    std::memset(bitboards_, 0, sizeof(bitboards_));
+    std::memset(occupancies_, 0, sizeof(occupancies_));
+    for (bool& right : castleRights_) right = false;
+    enPassantTarget_ = -1;
+    zobristKey_ = calculateHash();
+    pawnKey_ = 0;
+    psqtScore_ = 0;
+    phase_ = 0;
+    nnueRefresh(accumulator_, *this);
+}
 
+void Board::placePiece(Color c, PieceType pt, int square) {
+    putPiece(c, pt, square);
     updateOccupancies();
     zobristKey_ = calculateHash();
 }
 
+// =======================
+//   FEN
+// =======================
+
+static const char pieceLetters[] = "PNBRQKAEHG";
+
+char Board::pieceToChar(Color c, PieceType pt) {
+    if (pt == PieceType::None) return '?';
+    char ch = pieceLetters[static_cast<int>(pt)];
+    return (c == Color::White) ? ch : static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+}
+
+bool Board::charToPiece(char ch, Color& c, PieceType& pt) {
+    const char* found = std::strchr(pieceLetters, std::toupper(static_cast<unsigned char>(ch)));
+    if (ch == '\0' || found == nullptr) return false;
+    c = std::isupper(static_cast<unsigned char>(ch)) ? Color::White : Color::Black;
+    pt = static_cast<PieceType>(found - pieceLetters);
+    return true;
+}
+
+bool Board::loadFen(const std::string& fen, Color& turn) {
+    std::istringstream iss(fen);
+    std::string placement, side = "w", castling = "-", enPassant = "-";
+    if (!(iss >> placement)) return false;
+    iss >> side >> castling >> enPassant;
+
+    // Built aside, so that a malformed string leaves this board untouched
+    Board board = *this;
+    board.clear();
+    int rank = 7, file = 0;
+    for (char ch : placement) {
+        if (ch == '/') {
+            if (file != 8 || rank == 0) return false;
+            --rank;
+            file = 0;
+            continue;
+        }
+        if (ch >= '1' && ch <= '8') {
+            file += ch - '0';
+            if (file > 8) return false;
+            continue;
+        }
+        Color c;
+        PieceType pt;
+        if (!charToPiece(ch, c, pt) || file > 7) return false;
+        board.putPiece(c, pt, rank * 8 + file);
+        ++file;
+    }
+    if (rank != 0 || file != 8) return false;
+    if (side != "w" && side != "b") return false;
+
+    // A right is only meaningful with the king and the rook at home
+    auto has = [&board](Color c, PieceType pt, int sq) { return getBit(board.getBitboard(c, pt), sq); };
+    for (char ch : castling) {
+        if      (ch == 'K') board.castleRights_[0] = has(Color::White, PieceType::King, 4)  && has(Color::White, PieceType::Rook, 7);
+        else if (ch == 'Q') board.castleRights_[1] = has(Color::White, PieceType::King, 4)  && has(Color::White, PieceType::Rook, 0);
+        else if (ch == 'k') board.castleRights_[2] = has(Color::Black, PieceType::King, 60) && has(Color::Black, PieceType::Rook, 63);
+        else if (ch == 'q') board.castleRights_[3] = has(Color::Black, PieceType::King, 60) && has(Color::Black, PieceType::Rook, 56);
+        else if (ch != '-') return false;
+    }
+    if (enPassant != "-") {
+        if (enPassant.size() != 2 || enPassant[0] < 'a' || enPassant[0] > 'h'
+            || (enPassant[1] != '3' && enPassant[1] != '6')) return false;
+        board.enPassantTarget_ = (enPassant[1] - '1') * 8 + (enPassant[0] - 'a');
+    }
+
+    board.updateOccupancies();
+    board.zobristKey_ = board.calculateHash();
+    *this = board;
+    turn = (side == "w") ? Color::White : Color::Black;
+    return true;
+}
+
+std::string Board::toFen(Color turn, int halfmoveClock, int fullmoveNumber) const {
+    std::string fen;
+    for (int rank = 7; rank >= 0; --rank) {
+        int empty = 0;
+        for (int file = 0; file < 8; ++file) {
+            Color c;
+            PieceType pt = getPieceTypeAt(rank * 8 + file, c);
+            if (pt == PieceType::None) {
+                ++empty;
+                continue;
+            }
+            if (empty) fen += static_cast<char>('0' + empty);
+            empty = 0;
+            fen += pieceToChar(c, pt);
+        }
+        if (empty) fen += static_cast<char>('0' + empty);
+        if (rank > 0) fen += '/';
+    }
+
+    fen += (turn == Color::White) ? " w " : " b ";
+    std::string castling;
+    if (castleRights_[0]) castling += 'K';
+    if (castleRights_[1]) castling += 'Q';
+    if (castleRights_[2]) castling += 'k';
+    if (castleRights_[3]) castling += 'q';
+    fen += castling.empty() ? "-" : castling;
+
+    fen += ' ';
+    if (enPassantTarget_ == -1) {
+        fen += '-';
+    } else {
+        fen += static_cast<char>('a' + enPassantTarget_ % 8);
+        fen += static_cast<char>('1' + enPassantTarget_ / 8);
+    }
+    fen += " " + std::to_string(halfmoveClock) + " " + std::to_string(fullmoveNumber);
+    return fen;
+}
+
 // =======================
 //   GENERATE LEGAL MOVES
 // =======================
@@ -201,9 +357,7 @@ const int kingOffsets[]   = {-9, -8, -7, -1, 1, 7, 8, 9};
 const int rookDirs[]   = {-8, 8, -1, 1};
 const int bishopDirs[] = {-9, -7, 7, 9};
 
-std::vector<Move> Board::generateLegalMoves(Color turn) const {
-    std::vector<Move> moves;
-    moves.reserve(35);
+void Board::generatePseudoLegalMoves(Color turn, std::vector<Move>& moves) const {
 
     int c = static_cast<int>(turn);
     int opp = c ^ 1;
@@ -531,20 +685,42 @@ std::vector<Move> Board::generateLegalMoves(Color turn) const {
         }
     }
 
+}
+
+bool Board::keepsKingSafe(const Move& move, Color turn) const {
+    Board tempBoard = *this;
+    tempBoard.movePiece(move.from, move.to, move.promotion);
+    return !tempBoard.isInCheck(turn);
+}
+
+std::vector<Move> Board::generateLegalMoves(Color turn) const {
+    std::vector<Move> moves;
+    moves.reserve(35);
+    generatePseudoLegalMoves(turn, moves);
+
     // --- Filter out moves that leave king in check ---
     std::vector<Move> realLegalMoves;
     realLegalMoves.reserve(moves.size());
 
     for (const auto& move : moves) {
-        Board tempBoard = *this;
-        tempBoard.movePiece(move.from, move.to, move.promotion);
-        if (!tempBoard.isInCheck(turn)) {
+        if (keepsKingSafe(move, turn)) {
             realLegalMoves.push_back(move);
         }
     }
 
     return realLegalMoves;
 }
+
+bool Board::hasAnyLegalMove(Color turn) const {
+    std::vector<Move> moves;
+    moves.reserve(35);
+    generatePseudoLegalMoves(turn, moves);
+
+    for (const auto& move : moves) {
+        if (keepsKingSafe(move, turn)) return true;
+    }
+    return false;
+}
 std::vector<Move> Board::generateCaptures(Color turn) const {
     std::vector<Move> moves;
     moves.reserve(10); // Captures are usually fewer
@@ -689,8 +865,187 @@ std::vector<Move> Board::generateCaptures(Color turn) const {
     generateSlidingCaptures(PieceType::Queen,  rookDirs,   4);
     generateSlidingCaptures(PieceType::Queen,  bishopDirs, 4);
 
+    // --- 5. FAIRY PIECES ---
+
+    // A. Princess (Bishop + Knight) and Empress (Rook + Knight)
+    generateSlidingCaptures(PieceType::Princess, bishopDirs, 4);
+    generateSlidingCaptures(PieceType::Empress,  rookDirs,   4);
+
+    Bitboard jumpers = bitboards_[c][static_cast<int>(PieceType::Princess)]
+                     | bitboards_[c][static_cast<int>(PieceType::Empress)];
+    while (jumpers) {
+        int sq = __builtin_ctzll(jumpers);
+        jumpers &= (jumpers - 1);
+
+        int x = sq % 8;
+        for (int offset : kOffsets) {
+            int target = sq + offset;
+            if (target >= 0 && target < 64 && std::abs((target % 8) - x) <= 2 && getBit(them, target)) {
+                Move m(sq, target);
+                m.isCapture = true;
+                moves.push_back(m);
+            }
+        }
+    }
+
+    // B. Nightrider: repeated knight jumps, captures the first enemy on the ray
+    Bitboard nightriders = bitboards_[c][static_cast<int>(PieceType::Nightrider)];
+    while (nightriders) {
+        int sq = __builtin_ctzll(nightriders);
+        nightriders &= (nightriders - 1);
+
+        for (int offset : kOffsets) {
+            int curSq = sq;
+            while (true) {
+                int nextSq = curSq + offset;
+                if (nextSq < 0 || nextSq >= 64) break;
+                if (std::abs((nextSq % 8) - (curSq % 8)) > 2) break; // Wrap guard
+                if (getBit(us, nextSq)) break;
+                if (getBit(them, nextSq)) {
+                    Move m(sq, nextSq);
+                    m.isCapture = true;
+                    moves.push_back(m);
+                    break;
+                }
+                curSq = nextSq;
+            }
+        }
+    }
+
+    // C. Grasshopper: jumps over the first piece, captures if it lands on an enemy
+    Bitboard grasshoppers = bitboards_[c][static_cast<int>(PieceType::Grasshopper)];
+    const int allDx[] = {-1, 0, 1, -1, 1, -1, 0, 1};
+    const int allDy[] = {-1, -1, -1, 0, 0, 1, 1, 1};
+    while (grasshoppers) {
+        int sq = __builtin_ctzll(grasshoppers);
+        grasshoppers &= (grasshoppers - 1);
+
+        for (int d = 0; d < 8; ++d) {
+            int curX = sq % 8 + allDx[d];
+            int curY = sq / 8 + allDy[d];
+            // Slide to the hurdle
+            while (curX >= 0 && curX <= 7 && curY >= 0 && curY <= 7 && !getBit(occupancies_[2], curY * 8 + curX)) {
+                curX += allDx[d];
+                curY += allDy[d];
+            }
+            // Land right behind it
+            curX += allDx[d];
+            curY += allDy[d];
+            if (curX < 0 || curX > 7 || curY < 0 || curY > 7) continue;
+            int landing = curY * 8 + curX;
+            if (getBit(them, landing)) {
+                Move m(sq, landing);
+                m.isCapture = true;
+                moves.push_back(m);
+            }
+        }
+    }
+
     return moves;
 }
+bool Board::isPseudoLegal(const Move& m, Color turn) const {
+    if (m.from < 0 || m.from >= 64 || m.to < 0 || m.to >= 64 || m.from == m.to) return false;
+
+    int c = static_cast<int>(turn);
+    if (!getBit(occupancies_[c], m.from)) return false; // must move our own piece
+    if (getBit(occupancies_[c], m.to)) return false;    // never capture our own piece
+
+    Color color;
+    PieceType pt = getPieceTypeAt(m.from, color);
+    if (pt != PieceType::Pawn && m.promotion != PieceType::None) return false;
+
+    bool enemyOnTarget = getBit(occupancies_[c ^ 1], m.to);
+
+    int fx = m.from % 8, fy = m.from / 8;
+    int tx = m.to % 8,   ty = m.to / 8;
+    int dx = tx - fx,    dy = ty - fy;
+    int adx = std::abs(dx), ady = std::abs(dy);
+    int sx = (dx > 0) - (dx < 0), sy = (dy > 0) - (dy < 0);
+
+    bool knightJump = (adx == 1 && ady == 2) || (adx == 2 && ady == 1);
+    bool straight   = (dx == 0) != (dy == 0);
+    bool diagonal   = (adx == ady);
+
+    // Every square strictly between from and to (along a line) must be empty
+    auto pathClear = [&]() {
+        for (int x = fx + sx, y = fy + sy; x != tx || y != ty; x += sx, y += sy) {
+            if (getBit(occupancies_[2], y * 8 + x)) return false;
+        }
+        return true;
+    };
+
+    switch (pt) {
+    case PieceType::Pawn: {
+        int up = (turn == Color::White) ? 1 : -1;
+        int startRank     = (turn == Color::White) ? 1 : 6;
+        int promotionRank = (turn == Color::White) ? 7 : 0;
+
+        // Promotion is mandatory on the last rank, and only to Q/R/B/N
+        if (ty == promotionRank) {
+            if (m.promotion != PieceType::Queen && m.promotion != PieceType::Rook &&
+                m.promotion != PieceType::Bishop && m.promotion != PieceType::Knight) return false;
+        } else if (m.promotion != PieceType::None) {
+            return false;
+        }
+
+        if (dx == 0) {
+            if (enemyOnTarget) return false;
+            if (dy == up) return true;
+            return dy == 2 * up && fy == startRank && !getBit(occupancies_[2], m.from + 8 * up);
+        }
+        return adx == 1 && dy == up && (enemyOnTarget || m.to == enPassantTarget_);
+    }
+    case PieceType::Knight:   return knightJump;
+    case PieceType::Bishop:   return diagonal && pathClear();
+    case PieceType::Rook:     return straight && pathClear();
+    case PieceType::Queen:    return (diagonal || straight) && pathClear();
+    case PieceType::Princess: return knightJump || (diagonal && pathClear());
+    case PieceType::Empress:  return knightJump || (straight && pathClear());
+
+    case PieceType::King: {
+        if (adx <= 1 && ady <= 1) return true;
+
+        // Castling: same conditions as in generateLegalMoves
+        if (dy != 0 || adx != 2 || m.from != (turn == Color::White ? 4 : 60)) return false;
+        bool kingSide = (dx > 0);
+        if (!canCastle(turn, kingSide)) return false;
+        int path1 = m.from + sx;
+        int path2 = m.from + 2 * sx;
+        if (getBit(occupancies_[2], path1) || getBit(occupancies_[2], path2)) return false;
+        if (isInCheck(turn)) return false;
+        return !isSquareAttacked(path1, opposite(turn)) && !isSquareAttacked(path2, opposite(turn));
+    }
+
+    case PieceType::Nightrider: {
+        // A whole number of identical knight jumps, landing squares in between empty
+        for (int k = 1; k < 8; ++k) {
+            if (dx % k != 0 || dy % k != 0) continue;
+            int ux = dx / k, uy = dy / k;
+            if (!((std::abs(ux) == 1 && std::abs(uy) == 2) || (std::abs(ux) == 2 && std::abs(uy) == 1))) continue;
+            for (int i = 1; i < k; ++i) {
+                if (getBit(occupancies_[2], (fy + i * uy) * 8 + fx + i * ux)) return false;
+            }
+            return true;
+        }
+        return false;
+    }
+
+    case PieceType::Grasshopper: {
+        // Lands right behind the first piece met along a queen line
+        if (!(diagonal || straight)) return false;
+        int hurdle = (ty - sy) * 8 + (tx - sx);
+        if (hurdle == m.from || !getBit(occupancies_[2], hurdle)) return false;
+        for (int x = fx + sx, y = fy + sy; y * 8 + x != hurdle; x += sx, y += sy) {
+            if (getBit(occupancies_[2], y * 8 + x)) return false;
+        }
+        return true;
+    }
+
+    default:
+        return false;
+    }
+}
+
 int Board::getKingSquare(Color c) const {
     Bitboard kingBB = bitboards_[static_cast<int>(c)][static_cast<int>(PieceType::King)];
     if (kingBB == 0) return -1;
@@ -924,23 +1279,21 @@ void Board::disableCastle(Color c, bool kingSide) {
 //   ZOBRIST IMPLEMENTATION
 // =======================
 void Board::initZobristKeys() {
-    if (zInitialized) return;
-    
-    // 64-bit random number generator (Mersenne Twister)
-    std::mt19937_64 rng(123456789);
-
-    for (int c = 0; c < 2; ++c) {
-        for (int p = 0; p < 10; ++p) {
-            for (int sq = 0; sq < 64; ++sq) {
-                zPieceKeys[c][p][sq] = rng();
+    std::call_once(zInitialized, []() {
+        // 64-bit random number generator (Mersenne Twister)
+        std::mt19937_64 rng(123456789);
+
+        for (int c = 0; c < 2; ++c) {
+            for (int p = 0; p < 10; ++p) {
+                for (int sq = 0; sq < 64; ++sq) {
+                    zPieceKeys[c][p][sq] = rng();
+                }
             }
         }
-    }
-    for (int sq = 0; sq < 65; ++sq) zEnPassantKeys[sq] = rng();
-    for (int k = 0; k < 16; ++k) zCastleKeys[k] = rng();
-    zSideKey = rng();
-
-    zInitialized = true;
+        for (int sq = 0; sq < 65; ++sq) zEnPassantKeys[sq] = rng();
+        for (int k = 0; k < 16; ++k) zCastleKeys[k] = rng();
+        zSideKey = rng();
+    });
 }
 
 // Optimized function to calculate the hash (uses bitboards as evaluate)
@@ -976,5 +1329,41 @@ uint64_t Board::calculateHash() const {
     return hash;
 }
 
+Score Board::calculatePsqtScore() const {
+    Score score = 0;
+    for (int c = 0; c < 2; ++c) {
+        for (int p = 0; p < 10; ++p) {
+            Bitboard bb = bitboards_[c][p];
+            while (bb) {
+                score += psqtTable[c][p][__builtin_ctzll(bb)];
+                bb &= (bb - 1);
+            }
+        }
+    }
+    return score;
+}
+
+int Board::calculatePhase() const {
+    int phase = 0;
+    for (int c = 0; c < 2; ++c) {
+        for (int p = 0; p < 10; ++p) {
+            phase += phaseWeights[p] * __builtin_popcountll(bitboards_[c][p]);
+        }
+    }
+    return phase;
+}
+
+uint64_t Board::calculatePawnHash() const {
+    uint64_t hash = 0;
+    for (int c = 0; c < 2; ++c) {
+        Bitboard bb = bitboards_[c][static_cast<int>(PieceType::Pawn)];
+        while (bb) {
+            hash ^= zPieceKeys[c][static_cast<int>(PieceType::Pawn)][__builtin_ctzll(bb)];
+            bb &= (bb - 1);
+        }
+    }
+    return hash;
+}
+
 
 
@@ -3,9 +3,12 @@
 #include <vector>
 #include <cstdint>
 #include <iostream>
+#include <string>
 
 #include "piece.h"
 #include "move.h"
+#include "psqt.h"
+#include "nnue.h"
 
 /**
  * @brief A bitboard is a 64-bit mask representing a set of squares.
@@ -67,6 +70,61 @@ class Board {
      */
     uint64_t zobristKey_ = 0;
 
+    /**
+     * @brief Zobrist hash key of the pawns only (both colors).
+     *
+     * Updated incrementally in movePiece(); used to index pawn-structure caches.
+     */
+    uint64_t pawnKey_ = 0;
+
+    /**
+     * @brief Sum of material + piece-square values (packed MG/EG, White's perspective).
+     *
+     * Updated incrementally by putPiece() / removePiece().
+     */
+    Score psqtScore_ = 0;
+
+    /**
+     * @brief Game phase: sum of @ref phaseWeights over the pieces on the board.
+     */
+    int phase_ = 0;
+
+    /**
+     * @brief NNUE first-layer outputs, updated by putPiece() / removePiece() once computed.
+     */
+    Accumulator accumulator_;
+
+    /**
+     * @brief Add a piece and update the incremental state (pawn key, PSQT score, phase, NNUE).
+     * @param c Piece color.
+     * @param pt Piece type.
+     * @param square Square index (0..63).
+     */
+    void putPiece(Color c, PieceType pt, int square);
+
+    /**
+     * @brief Remove a piece and update the incremental state (pawn key, PSQT score, phase, NNUE).
+     * @param c Piece color.
+     * @param pt Piece type.
+     * @param square Square index (0..63).
+     */
+    void removePiece(Color c, PieceType pt, int square);
+
+    /**
+     * @brief Append the pseudo-legal moves of @p turn (king safety not checked).
+     * @param turn Side to play.
+     * @param moves Output list.
+     */
+    void generatePseudoLegalMoves(Color turn, std::vector<Move>& moves) const;
+
+    /**
+     * @brief Check that a pseudo-legal move does not leave the mover's king in check.
+     * @param move Pseudo-legal move.
+     * @param turn Side to play.
+     * @return True if the move is legal.
+     */
+    bool keepsKingSafe(const Move& move, Color turn) const;
+
 public:
     /**
      * @brief Construct a board and initialize it to the starting position.
@@ -84,6 +142,39 @@ public:
         return bitboards_[static_cast<int>(c)][static_cast<int>(pt)];
     }
 
+    /**
+     * @brief Get the bitboard of all occupied squares.
+     * @return Bitboard with one bit set per piece on the board (both colors).
+     */
+    Bitboard getOccupancy() const { return occupancies_[2]; }
+
+    /**
+     * @brief Get the incrementally maintained material + piece-square score.
+     * @return Packed MG/EG score from White's perspective.
+     */
+    Score getPsqtScore() const { return psqtScore_; }
+
+    /**
+     * @brief Get the incrementally maintained game phase.
+     * @return Phase (may exceed @ref MAX_PHASE with fairy armies).
+     */
+    int getPhase() const { return phase_; }
+
+    /**
+     * @brief Get the NNUE accumulator of the position.
+     * @return Accumulator; only valid if its generation matches nnueGeneration().
+     */
+    const Accumulator& getAccumulator() const { return accumulator_; }
+
+    /**
+     * @brief Recompute the NNUE accumulator if it was built for another network (or none).
+     *
+     * Call once on a root position after loading a network; moves then keep it up to date.
+     */
+    void refreshAccumulator() {
+        if (accumulator_.generation != nnueGeneration()) nnueRefresh(accumulator_, *this);
+    }
+
     /**
      * @brief Get the piece type located at a square.
      * @param square Square index (0..63).
@@ -145,6 +236,71 @@ public:
      */
     void movePiece(int from, int to, PieceType promotion = PieceType::None);
 
+    /**
+     * @brief Pass the turn without moving ("null move"), used by null-move pruning.
+     *
+     * The board does not store the side to move (the search tracks it), so
+     * passing only clears the en passant target. The hash is updated
+     * incrementally.
+     */
+    void makeNullMove();
+
+    /**
+     * @brief Remove every piece (no castling rights, no en passant target).
+     *
+     * Used with @ref placePiece to set up arbitrary positions.
+     */
+    void clear();
+
+    /**
+     * @brief Put a piece on an empty square, keeping all incremental state consistent.
+     * @param c Piece color.
+     * @param pt Piece type.
+     * @param square Square index (0..63).
+     */
+    void placePiece(Color c, PieceType pt, int square);
+
+    /**
+     * @brief Set up a position from a FEN string.
+     *
+     * Piece letters are the standard ones plus A (princess), E (empress), H (nightrider)
+     * and G (grasshopper), uppercase for White. Only the placement field is required:
+     * the side to move defaults to White, castling and en passant to none. Castling
+     * rights are kept only when the king and rook stand on their initial squares.
+     * The move counters are accepted but not stored. On failure the board is unchanged.
+     *
+     * @param fen FEN string.
+     * @param turn Output: side to move.
+     * @return False if the string is malformed.
+     */
+    bool loadFen(const std::string& fen, Color& turn);
+
+    /**
+     * @brief Write the position as a FEN string (same piece letters as @ref loadFen).
+     * @param turn Side to move.
+     * @param halfmoveClock Halfmove clock field.
+     * @param fullmoveNumber Fullmove number field.
+     * @return FEN string.
+     */
+    std::string toFen(Color turn, int halfmoveClock = 0, int fullmoveNumber = 1) const;
+
+    /**
+     * @brief FEN letter of a piece.
+     * @param c Piece color (White gives uppercase).
+     * @param pt Piece type.
+     * @return Letter, or '?' for PieceType::None.
+     */
+    static char pieceToChar(Color c, PieceType pt);
+
+    /**
+     * @brief Decode a FEN piece letter.
+     * @param ch Letter.
+     * @param c Output: color (uppercase = White).
+     * @param pt Output: piece type.
+     * @return False if the letter is not a known piece.
+     */
+    static bool charToPiece(char ch, Color& c, PieceType& pt);
+
     /**
      * @brief Generate all legal moves for the given side to play.
      *
@@ -156,6 +312,17 @@ public:
      */
     std::vector<Move> generateLegalMoves(Color turn) const;
 
+    /**
+     * @brief Check whether the given side has at least one legal move.
+     *
+     * Stops at the first pseudo-legal move that keeps the king safe, which is
+     * much cheaper than @ref generateLegalMoves when only mate/stalemate matters.
+     *
+     * @param turn Side to play.
+     * @return False if @p turn is checkmated or stalemated.
+     */
+    bool hasAnyLegalMove(Color turn) const;
+
     /**
      * @brief Generate capture moves only (used for quiescence search).
      *
@@ -167,6 +334,19 @@ public:
      */
     std::vector<Move> generateCaptures(Color turn) const;
 
+    /**
+     * @brief Check whether a move is pseudo-legal for the given side.
+     *
+     * Accepts exactly the moves @ref generateLegalMoves would generate before
+     * its king-safety filter, without generating anything. Used to validate a
+     * hash move (which may come from a colliding position) before searching it.
+     *
+     * @param m Move to test (from, to, promotion).
+     * @param turn Side to play.
+     * @return True if the move follows the movement rules of the piece on @p m.from.
+     */
+    bool isPseudoLegal(const Move& m, Color turn) const;
+
     /**
      * @brief Recompute occupancy bitboards from per-piece bitboards.
      *
@@ -240,10 +420,16 @@ public:
      */
     uint64_t getHash() const { return zobristKey_; }
 
+    /**
+     * @brief Get the Zobrist key of the pawn structure.
+     * @return 64-bit key depending only on the pawn squares of both sides.
+     */
+    uint64_t getPawnHash() const { return pawnKey_; }
+
     /**
      * @brief Initialize Zobrist random keys (static).
      *
-     * Must be called at least once before hashing is used.
+     * Must be called at least once before hashing is used; thread-safe.
      *
      */
     static void initZobristKeys();
@@ -257,4 +443,22 @@ public:
      * @return 64-bit hash key for the current position.
      */
     uint64_t calculateHash() const;
+
+    /**
+     * @brief Recompute the pawn-structure key from scratch.
+     * @return 64-bit key of the pawn squares of both sides.
+     */
+    uint64_t calculatePawnHash() const;
+
+    /**
+     * @brief Recompute the material + piece-square score from scratch.
+     * @return Packed MG/EG score from White's perspective.
+     */
+    Score calculatePsqtScore() const;
+
+    /**
+     * @brief Recompute the game phase from scratch.
+     * @return Sum of @ref phaseWeights over the pieces on the board.
+     */
+    int calculatePhase() const;
 };
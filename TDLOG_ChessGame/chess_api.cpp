@@ -0,0 +1,195 @@
+#include "chess_api.h"
+#include "ai.h"
+#include "game.h"
+
+#include <cstring>
+#include <string>
+
+struct ChessGame {
+    Game game;
+};
+
+struct ChessEngine {
+    AI ai;
+    explicit ChessEngine(int depth) : ai(new MaterialAndPositionEvaluation(), depth) {
+        // The best move must be the one of the reported PV, found with the configured threads
+        ai.setRandomRootChoice(false);
+    }
+};
+
+// Copies text into a caller buffer with the snprintf convention
+static size_t copyOut(const std::string& text, char* buffer, size_t size) {
+    if (buffer && size > 0) {
+        size_t n = (text.size() < size) ? text.size() : size - 1;
+        std::memcpy(buffer, text.data(), n);
+        buffer[n] = '\0';
+    }
+    return text.size();
+}
+
+// No C++ exception may cross the C boundary: every entry point that can throw
+// catches them and reports a failure instead (NULL, 0 or an empty text). The
+// others only read or assign plain values, and the free functions only run
+// destructors, which do not throw.
+
+ChessGame* chess_game_new(int variant) {
+    try {
+        ChessGame* handle = new ChessGame();
+        handle->game.startGame(variant == CHESS_VARIANT_FAIRY ? Variant::FairyChess : Variant::Classic);
+        return handle;
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void chess_game_free(ChessGame* game) {
+    delete game;
+}
+
+int chess_game_set_fen(ChessGame* game, const char* fen) {
+    if (!game || !fen) return 0;
+    try {
+        return game->game.setPosition(fen) ? 1 : 0;
+    } catch (...) {
+        return 0;
+    }
+}
+
+int chess_game_play(ChessGame* game, const char* move) {
+    if (!game || !move) return 0;
+    try {
+        Move m = moveFromUci(move);
+        return (m.from >= 0 && game->game.playMove(m)) ? 1 : 0;
+    } catch (...) {
+        return 0;
+    }
+}
+
+size_t chess_game_legal_moves(const ChessGame* game, char* buffer, size_t size) {
+    try {
+        std::string text;
+        if (game) {
+            for (const auto& m : game->game.legalMoves()) {
+                if (!text.empty()) text += ' ';
+                text += moveToUci(m);
+            }
+        }
+        return copyOut(text, buffer, size);
+    } catch (...) {
+        return copyOut(std::string(), buffer, size);
+    }
+}
+
+size_t chess_game_board(const ChessGame* game, char* buffer, size_t size) {
+    try {
+        std::string cells;
+        if (game) {
+            cells.assign(64, '-');
+            const Board& board = game->game.board();
+            for (int sq = 0; sq < 64; ++sq) {
+                Color c;
+                PieceType pt = board.getPieceTypeAt(sq, c);
+                // Rank 8 first, as printed by the text protocol
+                if (pt != PieceType::None) cells[(7 - sq / 8) * 8 + sq % 8] = Board::pieceToChar(c, pt);
+            }
+        }
+        return copyOut(cells, buffer, size);
+    } catch (...) {
+        return copyOut(std::string(), buffer, size);
+    }
+}
+
+size_t chess_game_fen(const ChessGame* game, char* buffer, size_t size) {
+    try {
+        std::string fen;
+        if (game) fen = game->game.board().toFen(game->game.currentTurn());
+        return copyOut(fen, buffer, size);
+    } catch (...) {
+        return copyOut(std::string(), buffer, size);
+    }
+}
+
+int chess_game_side_to_move(const ChessGame* game) {
+    return (game && game->game.currentTurn() == Color::Black) ? 1 : 0;
+}
+
+int chess_game_state(const ChessGame* game) {
+    return game ? static_cast<int>(game->game.gameState()) : CHESS_STATE_PLAYING;
+}
+
+ChessEngine* chess_engine_new(int depth) {
+    try {
+        return new ChessEngine(depth > 0 ? depth : 5);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void chess_engine_free(ChessEngine* engine) {
+    delete engine; // ~AI stops and joins the search thread
+}
+
+void chess_engine_set_threads(ChessEngine* engine, int threads) {
+    if (engine) engine->ai.setThreads(threads);
+}
+
+void chess_engine_set_hash(ChessEngine* engine, int mb) {
+    if (engine && mb > 0) engine->ai.setHashSize(static_cast<size_t>(mb));
+}
+
+void chess_engine_set_info_callback(ChessEngine* engine, ChessInfoCallback callback, void* userData) {
+    if (!engine) return;
+    try {
+        if (!callback) {
+            engine->ai.setInfoCallback(nullptr);
+            return;
+        }
+        // Runs on the search thread: an exception there would end the process, so it stays inside
+        engine->ai.setInfoCallback([callback, userData](const SearchInfo& info) {
+            try {
+                std::string pv;
+                for (const auto& m : info.pv) {
+                    if (!pv.empty()) pv += ' ';
+                    pv += moveToUci(m);
+                }
+                callback(info.depth, info.score, info.mateIn, info.nodes, pv.c_str(), userData);
+            } catch (...) {
+            }
+        });
+    } catch (...) {
+        engine->ai.setInfoCallback(nullptr);
+    }
+}
+
+int chess_engine_start(ChessEngine* engine, const ChessGame* game, int depth, int64_t moveTimeMs,
+                       ChessBestMoveCallback onBestMove, void* userData) {
+    if (!engine || !game || depth < 0 || moveTimeMs < 0) return 0;
+    try {
+        SearchLimits limits;
+        limits.depth = depth;
+        limits.moveTimeMs = moveTimeMs;
+        engine->ai.startSearch(game->game.board(), game->game.currentTurn(), limits,
+                               [onBestMove, userData](Move best) {
+                                   // Same as the info callback: nothing may escape the search thread
+                                   try {
+                                       if (onBestMove) onBestMove(moveToUci(best).c_str(), userData);
+                                   } catch (...) {
+                                   }
+                               });
+        return 1;
+    } catch (...) {
+        return 0;
+    }
+}
+
+void chess_engine_stop(ChessEngine* engine) {
+    if (engine) engine->ai.stop();
+}
+
+void chess_engine_wait(ChessEngine* engine) {
+    if (!engine) return;
+    try {
+        engine->ai.waitForSearch();
+    } catch (...) {
+    }
+}
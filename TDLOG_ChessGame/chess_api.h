@@ -0,0 +1,136 @@
+#pragma once
+
+/**
+ * @file chess_api.h
+ * @brief C interface of the chess_core library, for in-process use (e.g. Python ctypes).
+ *
+ * Handles are opaque; every function accepts only C types. Moves are written in
+ * UCI long algebraic notation ("e2e4", "e7e8q"). Functions filling a text buffer
+ * follow the snprintf convention: they write at most @p size bytes (always
+ * NUL-terminated when size > 0) and return the full length of the text.
+ *
+ * No C++ exception escapes these functions: failures are reported as NULL, 0
+ * or an empty text. Different handles may be created and used from different
+ * threads, but one game handle must not be used from several threads at once.
+ * An engine may be stopped from any thread while it searches.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(CHESS_CORE_BUILD)
+#    define CHESS_API __declspec(dllexport)
+#  elif defined(CHESS_CORE_DLL)
+#    define CHESS_API __declspec(dllimport)
+#  else
+#    define CHESS_API
+#  endif
+#else
+#  define CHESS_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Opaque game: board, side to move and state. */
+typedef struct ChessGame ChessGame;
+
+/** @brief Opaque engine: an AI with its own hash table and search threads. */
+typedef struct ChessEngine ChessEngine;
+
+/**
+ * @brief Receives the best move of a finished search ("0000" if there is none).
+ *
+ * Called on the engine's search thread.
+ */
+typedef void (*ChessBestMoveCallback)(const char* move, void* userData);
+
+/**
+ * @brief Receives one line per completed iteration: score in centipawns from the side
+ *        to move's point of view, or mate in moves when mateIn != 0.
+ *
+ * Called on the engine's search thread; @p pv is a space-separated list of moves.
+ */
+typedef void (*ChessInfoCallback)(int depth, int scoreCp, int mateIn, uint64_t nodes,
+                                  const char* pv, void* userData);
+
+/** @brief Game variants accepted by chess_game_new(). */
+enum { CHESS_VARIANT_CLASSIC = 0, CHESS_VARIANT_FAIRY = 1 };
+
+/** @brief Values returned by chess_game_state() (same order as GameState). */
+enum { CHESS_STATE_PLAYING = 0, CHESS_STATE_CHECK = 1, CHESS_STATE_CHECKMATE = 2, CHESS_STATE_STALEMATE = 3 };
+
+/* --- Game --- */
+
+/** @brief Start a game from the initial position of @p variant; NULL on failure. */
+CHESS_API ChessGame* chess_game_new(int variant);
+
+/** @brief Release a game (NULL is accepted). */
+CHESS_API void chess_game_free(ChessGame* game);
+
+/** @brief Set the position from a FEN string; 0 if it is malformed (the game is then unchanged). */
+CHESS_API int chess_game_set_fen(ChessGame* game, const char* fen);
+
+/** @brief Play a move for the side to move; 0 if it is malformed or illegal. */
+CHESS_API int chess_game_play(ChessGame* game, const char* move);
+
+/** @brief Space-separated legal moves of the side to move. */
+CHESS_API size_t chess_game_legal_moves(const ChessGame* game, char* buffer, size_t size);
+
+/**
+ * @brief The 64 squares from a8 to h1, one character each: uppercase for White,
+ *        lowercase for Black, '-' for an empty square.
+ */
+CHESS_API size_t chess_game_board(const ChessGame* game, char* buffer, size_t size);
+
+/** @brief FEN string of the position. */
+CHESS_API size_t chess_game_fen(const ChessGame* game, char* buffer, size_t size);
+
+/** @brief Side to move: 0 for White, 1 for Black. */
+CHESS_API int chess_game_side_to_move(const ChessGame* game);
+
+/** @brief State of the side to move (CHESS_STATE_*). */
+CHESS_API int chess_game_state(const ChessGame* game);
+
+/* --- Engine --- */
+
+/** @brief Create an engine searching @p depth plies by default; NULL on failure. */
+CHESS_API ChessEngine* chess_engine_new(int depth);
+
+/** @brief Stop any running search, wait for it and release the engine (NULL is accepted). */
+CHESS_API void chess_engine_free(ChessEngine* engine);
+
+/** @brief Number of search threads (0 = all hardware threads). */
+CHESS_API void chess_engine_set_threads(ChessEngine* engine, int threads);
+
+/** @brief Hash table size in MB, allocated at the next search. */
+CHESS_API void chess_engine_set_hash(ChessEngine* engine, int mb);
+
+/** @brief Set (or clear, with NULL) the per-iteration callback. Not while searching. */
+CHESS_API void chess_engine_set_info_callback(ChessEngine* engine, ChessInfoCallback callback, void* userData);
+
+/**
+ * @brief Search the current position of @p game in the background.
+ *
+ * Waits for the previous search first. The position is copied, so the game
+ * may be changed or released while the engine searches.
+ *
+ * @param depth Maximum depth in plies (0 = the engine's default).
+ * @param moveTimeMs Time budget in milliseconds (0 = no time limit).
+ * @param onBestMove Called once with the result (may be NULL).
+ * @return 0 if an argument is invalid or the search thread cannot be started, 1 otherwise.
+ */
+CHESS_API int chess_engine_start(ChessEngine* engine, const ChessGame* game, int depth, int64_t moveTimeMs,
+                                 ChessBestMoveCallback onBestMove, void* userData);
+
+/** @brief Ask the running search to return its best move as soon as possible (thread-safe). */
+CHESS_API void chess_engine_stop(ChessEngine* engine);
+
+/** @brief Block until the running search, and its callback, have finished. */
+CHESS_API void chess_engine_wait(ChessEngine* engine);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,189 @@
+#include "datagen.h"
+#include "ai.h"
+#include "game.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <thread>
+
+// --- RECORD FORMAT ---
+
+static void writeBits(uint8_t* bytes, int bitPos, int value) {
+    for (int i = 0; i < 5; ++i, ++bitPos) {
+        if (value & (1 << i)) bytes[bitPos / 8] |= static_cast<uint8_t>(1 << (bitPos % 8));
+    }
+}
+
+static int readBits(const uint8_t* bytes, int bitPos) {
+    int value = 0;
+    for (int i = 0; i < 5; ++i, ++bitPos) {
+        if (bytes[bitPos / 8] & (1 << (bitPos % 8))) value |= (1 << i);
+    }
+    return value;
+}
+
+bool packPosition(const Board& board, Color turn, int score, bool fairy, PackedPosition& record) {
+    record = PackedPosition();
+    record.occupancy = board.getOccupancy();
+    if (__builtin_popcountll(record.occupancy) > 32) return false;
+
+    int index = 0;
+    Bitboard bb = record.occupancy;
+    while (bb) {
+        int sq = __builtin_ctzll(bb);
+        Color c;
+        PieceType pt = board.getPieceTypeAt(sq, c);
+        writeBits(record.pieces, 5 * index++, static_cast<int>(c) * 10 + static_cast<int>(pt));
+        bb &= (bb - 1);
+    }
+
+    record.score = static_cast<int16_t>(std::max(-32767, std::min(32767, score)));
+    record.result = 0;
+    record.flags = static_cast<uint8_t>((turn == Color::Black ? 1 : 0) | (fairy ? 2 : 0));
+    return true;
+}
+
+bool unpackPosition(const PackedPosition& record, Board& board) {
+    board.clear();
+    int index = 0;
+    Bitboard bb = record.occupancy;
+    while (bb) {
+        int code = readBits(record.pieces, 5 * index++);
+        if (code >= 20) return false;
+        board.placePiece(static_cast<Color>(code / 10), static_cast<PieceType>(code % 10), __builtin_ctzll(bb));
+        bb &= (bb - 1);
+    }
+    return true;
+}
+
+// --- BUFFERED WRITER ---
+
+RecordWriter::RecordWriter(const std::string& path, size_t capacity)
+    : out(path, std::ios::binary | std::ios::trunc), capacity(capacity) {
+    buffer.reserve(capacity);
+}
+
+RecordWriter::~RecordWriter() {
+    flush();
+}
+
+void RecordWriter::write(const std::vector<PackedPosition>& records) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& record : records) {
+        buffer.push_back(record);
+        if (buffer.size() >= capacity) flushLocked();
+    }
+    written += records.size();
+}
+
+void RecordWriter::flush() {
+    std::lock_guard<std::mutex> lock(mutex);
+    flushLocked();
+}
+
+uint64_t RecordWriter::count() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return written;
+}
+
+void RecordWriter::flushLocked() {
+    if (buffer.empty()) return;
+    out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(PackedPosition));
+    out.flush();
+    buffer.clear();
+}
+
+// --- SELF-PLAY ---
+
+// True if the move takes something or promotes (the position before it is not quiet)
+static bool isNoisy(const Board& board, const Move& m) {
+    if (m.promotion != PieceType::None || board.isSquareOccupied(m.to)) return true;
+    Color c;
+    return board.getPieceTypeAt(m.from, c) == PieceType::Pawn && (m.from % 8) != (m.to % 8); // en passant
+}
+
+// Plays one game and returns its sampled positions, labeled with the result
+static std::vector<PackedPosition> playGame(AI& ai, int gameIndex, const DatagenConfig& config) {
+    bool fairy = (gameIndex % 2 == 1);
+    std::mt19937 rng(static_cast<unsigned>(gameIndex) * 2654435761u + 1);
+    SearchLimits limits;
+    limits.nodes = config.nodes;
+
+    Game game;
+    game.startGame(fairy ? Variant::FairyChess : Variant::Classic);
+    std::vector<PackedPosition> samples;
+    int result = 0; // draw unless someone is mated
+
+    for (int ply = 0; ply < config.maxPlies; ++ply) {
+        const Board& board = game.board();
+        Color turn = game.currentTurn();
+        const std::vector<Move>& moves = game.legalMoves();
+        if (moves.empty()) {
+            if (board.isInCheck(turn)) result = (turn == Color::White) ? -1 : 1;
+            break;
+        }
+        if (__builtin_popcountll(board.getOccupancy()) == 2) break; // bare kings
+
+        Move move;
+        if (ply < config.randomPlies) {
+            move = moves[rng() % moves.size()];
+        } else {
+            move = ai.getBestMove(board, turn, limits);
+            int score = ai.lastSearchScore();
+            bool mateScore = std::abs(score) >= MATE_VALUE - MAX_DEPTH;
+            PackedPosition record;
+            if (!mateScore && !board.isInCheck(turn) && !isNoisy(board, move)
+                && packPosition(board, turn, (turn == Color::White) ? score : -score, fairy, record)) {
+                samples.push_back(record);
+            }
+        }
+        if (!game.playMove(move)) break;
+    }
+
+    for (auto& record : samples) record.result = static_cast<int8_t>(result);
+    return samples;
+}
+
+int runDatagen(const DatagenConfig& config) {
+    RecordWriter writer(config.output);
+    if (!writer.isOpen()) {
+        std::cerr << "datagen: cannot open " << config.output << std::endl;
+        return 1;
+    }
+
+    int numThreads = (config.threads > 0) ? config.threads : static_cast<int>(std::thread::hardware_concurrency());
+    numThreads = std::max(1, std::min(numThreads, config.games));
+
+    std::atomic<int> nextGame{0};
+    std::atomic<int> finished{0};
+    std::mutex logMutex;
+    auto start = std::chrono::steady_clock::now();
+
+    // One game at a time per worker, each with its own single-threaded AI
+    auto worker = [&]() {
+        AI ai(new MaterialAndPositionEvaluation(), 1);
+        ai.setThreads(1);
+        ai.setRandomRootChoice(false); // its shared random generator is not thread-safe
+        ai.setHashSize(config.hashMb);
+        int g;
+        while ((g = nextGame++) < config.games) {
+            writer.write(playGame(ai, g, config));
+            int done = ++finished;
+            if (done % 50 == 0 || done == config.games) {
+                double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                std::lock_guard<std::mutex> lock(logMutex);
+                std::cout << "Games " << done << "/" << config.games << ", positions " << writer.count()
+                          << ", " << s << " s" << std::endl;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numThreads; ++i) threads.emplace_back(worker);
+    for (auto& t : threads) t.join();
+    writer.flush();
+    return 0;
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "board.h"
+
+/**
+ * @brief One training position in 32 bytes (fixed-size binary record).
+ *
+ * Pieces are stored in square order (the bit order of @ref occupancy), 5 bits each,
+ * with code color * 10 + piece type. 32 pieces fit in the 20 bytes of @ref pieces.
+ * Multi-byte fields are little-endian.
+ */
+struct PackedPosition {
+    uint64_t occupancy;  ///< Occupied squares.
+    uint8_t pieces[20];  ///< Bit-packed 5-bit piece codes.
+    int16_t score;       ///< Search score in centipawns, from White's perspective.
+    int8_t result;       ///< Game result: 1 = White won, 0 = draw, -1 = Black won.
+    uint8_t flags;       ///< Bit 0: Black to move. Bit 1: fairy variant.
+};
+static_assert(sizeof(PackedPosition) == 32, "PackedPosition must stay 32 bytes");
+
+/**
+ * @brief Encode a position (the result is filled in once the game is over).
+ * @param board Position to encode.
+ * @param turn Side to move.
+ * @param score Search score from White's perspective (clamped to 16 bits).
+ * @param fairy True for the fairy-chess variant.
+ * @param record Output record.
+ * @return False if the position has more than 32 pieces.
+ */
+bool packPosition(const Board& board, Color turn, int score, bool fairy, PackedPosition& record);
+
+/**
+ * @brief Decode the pieces of a record onto a board.
+ *
+ * Castling rights and en passant are not stored; the board gets none.
+ *
+ * @param record Record to decode.
+ * @param board Output board.
+ * @return False if the record contains an invalid piece code.
+ */
+bool unpackPosition(const PackedPosition& record, Board& board);
+
+/**
+ * @brief Thread-safe buffered writer of @ref PackedPosition records.
+ *
+ * Records are appended to an in-memory buffer and written to the file in large blocks.
+ */
+class RecordWriter {
+public:
+    /**
+     * @brief Open (truncate) the output file.
+     * @param path Output path.
+     * @param capacity Number of records buffered before a write.
+     */
+    explicit RecordWriter(const std::string& path, size_t capacity = 1 << 15);
+
+    /**
+     * @brief Flush the remaining records.
+     */
+    ~RecordWriter();
+
+    /**
+     * @brief Check that the output file could be opened.
+     * @return True if records can be written.
+     */
+    bool isOpen() const { return out.is_open(); }
+
+    /**
+     * @brief Append records (thread-safe).
+     * @param records Records to append, typically the samples of one finished game.
+     */
+    void write(const std::vector<PackedPosition>& records);
+
+    /**
+     * @brief Write the buffered records to the file (thread-safe).
+     */
+    void flush();
+
+    /**
+     * @brief Number of records accepted so far.
+     * @return Record count.
+     */
+    uint64_t count();
+
+private:
+    void flushLocked();
+
+    std::ofstream out;
+    std::vector<PackedPosition> buffer;
+    size_t capacity;
+    uint64_t written = 0;
+    std::mutex mutex;
+};
+
+/**
+ * @brief Settings of a self-play data generation run.
+ */
+struct DatagenConfig {
+    int games = 1000;        ///< Number of games to play (alternating Classic / FairyChess).
+    int64_t nodes = 5000;    ///< Node budget of each move search.
+    int threads = 0;         ///< Concurrent games, one per worker thread (0 = one per hardware thread).
+    int randomPlies = 8;     ///< Random opening moves played before the engines take over.
+    int maxPlies = 400;      ///< Games reaching this length are scored as draws.
+    size_t hashMb = 16;      ///< Transposition table size of each worker's AI.
+    std::string output = "data.bin"; ///< Output file of @ref PackedPosition records.
+};
+
+/**
+ * @brief Play self-play games and write sampled positions with their scores and results.
+ *
+ * Only quiet positions are kept: no check, a non-capturing best move, and no mate score.
+ *
+ * @param config Run settings.
+ * @return 0 on success, 1 if the output file cannot be opened.
+ */
+int runDatagen(const DatagenConfig& config);
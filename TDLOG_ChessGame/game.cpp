@@ -11,15 +11,31 @@ Game::Game() : board_(), currentTurn_(Color::White) {
 void Game::startGame(Variant v) {
     board_ = Board(v); // We re-initialize the board with the chosen variant
     currentTurn_ = Color::White;
+    state_ = GameState::Playing;
+    legalMovesValid_ = false;
 }
 
-bool Game::playMove(const Move& moveReq) {
-    // 1. Generate legal moves
-    std::vector<Move> legalMoves = board_.generateLegalMoves(currentTurn_);
+bool Game::setPosition(const std::string& fen) {
+    Color turn;
+    if (!board_.loadFen(fen, turn)) return false;
+    currentTurn_ = turn;
+    legalMovesValid_ = false;
+    updateState();
+    return true;
+}
+
+const std::vector<Move>& Game::legalMoves() const {
+    if (!legalMovesValid_) {
+        legalMoves_ = board_.generateLegalMoves(currentTurn_);
+        legalMovesValid_ = true;
+    }
+    return legalMoves_;
+}
 
-    // 2. Validate the move
+bool Game::playMove(const Move& moveReq) {
+    // 1-2. Validate the move against the cached legal moves
     bool found = false;
-    for (const auto& m : legalMoves) {
+    for (const auto& m : legalMoves()) {
         if (m.from == moveReq.from && m.to == moveReq.to && m.promotion == moveReq.promotion) {
             found = true;
             break;
@@ -32,12 +48,19 @@ bool Game::playMove(const Move& moveReq) {
     board_.movePiece(moveReq.from, moveReq.to, moveReq.promotion);
 
     currentTurn_ = opposite(currentTurn_);
+    legalMovesValid_ = false;
 
     // 4. Update state (Checkmate/Stalemate logic)
-    std::vector<Move> nextMoves = board_.generateLegalMoves(currentTurn_);
+    updateState();
+    return true;
+}
+
+void Game::updateState() {
+    // Only the existence of a reply matters here: the full list is generated lazily
+    bool hasMove = legalMovesValid_ ? !legalMoves_.empty() : board_.hasAnyLegalMove(currentTurn_);
     bool inCheck = board_.isInCheck(currentTurn_);
 
-    if (nextMoves.empty()) {
+    if (!hasMove) {
         if (inCheck) {
             state_ = GameState::Checkmate;
         } else {
@@ -50,6 +73,4 @@ bool Game::playMove(const Move& moveReq) {
             state_ = GameState::Playing;
         }
     }
-
-    return true;
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string>
 #include <vector>
 #include "board.h"
 #include "piece.h"   ///< Defines the Color enum.
@@ -34,6 +35,14 @@ class Game {
     GameState state_{GameState::Playing};///< Current game state.
     int promPos;                         ///< Board square of the pawn to promote.
 
+    mutable std::vector<Move> legalMoves_;  ///< Legal moves of the side to move (see legalMoves()).
+    mutable bool legalMovesValid_ = false;  ///< False until legalMoves_ is generated for the current position.
+
+    /**
+     * @brief Recompute @ref state_ for the side to move.
+     */
+    void updateState();
+
 public:
     /**
      * @brief Construct a new game.
@@ -51,11 +60,31 @@ public:
      */
     void startGame(Variant v = Variant::Classic);
 
+    /**
+     * @brief Start from an arbitrary position given as a FEN string.
+     *
+     * The side to move and the game state are taken from the position.
+     *
+     * @param fen FEN string (see Board::loadFen()).
+     * @return False if the string is malformed (the game is then unchanged).
+     */
+    bool setPosition(const std::string& fen);
+
+    /**
+     * @brief Legal moves of the side to move.
+     *
+     * Generated on first use after each position change and cached until
+     * the next one, so validation and GUI queries share a single generation.
+     *
+     * @return Const reference to the cached list (invalidated by the next move).
+     */
+    const std::vector<Move>& legalMoves() const;
+
     /**
      * @brief Play a move for the current player.
      *
-     * The move is checked against the list of legal moves generated
-     * from the current position. If the move is legal, it is applied,
+     * The move is checked against the cached list of legal moves
+     * of the current position (see legalMoves()). If the move is legal, it is applied,
      * the turn is switched, and the game state is updated accordingly.
      *
      * @param move Requested move.
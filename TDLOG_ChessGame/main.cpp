@@ -2,53 +2,77 @@
 #include <string>
 #include <vector>
 #include <sstream>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include "game.h"
 #include "board.h"
 #include "move.h"
 #include "ai.h"
 #include "player.h"
+#include "datagen.h"
+#include "bench.h"
+#include "uciwriter.h"
 
 // ======================================================
 //                    UTILITY FUNCTIONS
 // ======================================================
 
-// Prints the board in a simple ASCII format.
-// Uppercase letters represent White pieces,
-// lowercase letters represent Black pieces.
-void print_board_raw(const Board& b) {
+// One character per square, rank 8 first: uppercase letters represent
+// White pieces, lowercase letters Black pieces, '-' an empty square.
+std::string boardCells(const Board& b) {
+    std::string cells(64, '-');
     for (int rank = 7; rank >= 0; --rank) {
         for (int file = 0; file < 8; ++file) {
-            int sq = rank * 8 + file;
             Color c;
-            PieceType pt = b.getPieceTypeAt(sq, c);
-
-            char ch = '-';
-            if (pt != PieceType::None) {
-                switch (pt) {
-                case PieceType::Pawn:   ch = 'P'; break;
-                case PieceType::Knight: ch = 'N'; break;
-                case PieceType::Bishop: ch = 'B'; break;
-                case PieceType::Rook:   ch = 'R'; break;
-                case PieceType::Queen:  ch = 'Q'; break;
-                case PieceType::King:   ch = 'K'; break;
-                case PieceType::Princess:    ch = 'A'; break;
-                case PieceType::Empress:     ch = 'E'; break;
-                case PieceType::Nightrider:  ch = 'H'; break;
-                case PieceType::Grasshopper: ch = 'G'; break;
-                default: break;
-                }
+            PieceType pt = b.getPieceTypeAt(rank * 8 + file, c);
+            if (pt != PieceType::None) cells[(7 - rank) * 8 + file] = Board::pieceToChar(c, pt);
+        }
+    }
+    return cells;
+}
 
-                // Black pieces are printed in lowercase
-                if (c == Color::Black) ch = (char)tolower(ch);
-            }
+// Prints the board in a simple ASCII format (8 lines of 8 space-separated cells).
+// The whole board is assembled first and written with a single flush.
+void print_board_raw(const Board& b) {
+    std::string cells = boardCells(b);
+    std::string out;
+    out.reserve(128);
+    for (int i = 0; i < 64; ++i) {
+        out += cells[i];
+        out += (i % 8 == 7) ? '\n' : ' ';
+    }
+    std::cout << out << std::flush;
+}
 
-            std::cout << ch;
-            if (file < 7) std::cout << ' ';
+// Answers a move with its status line ("VAL"/"ILL") followed by the board, in one write.
+// With diffOnly, the board is replaced by a single "DIF" line listing the squares
+// changed since the last update (e.g. "DIF e2=- e4=P"); shown holds the cells sent so far.
+void print_board_update(const char* status, const Board& b, std::string& shown, bool diffOnly) {
+    std::string cells = boardCells(b);
+    std::string out = status;
+    out += '\n';
+    if (diffOnly && shown.size() == 64) {
+        out += "DIF";
+        for (int i = 0; i < 64; ++i) {
+            if (cells[i] == shown[i]) continue;
+            out += ' ';
+            out += static_cast<char>('a' + i % 8);
+            out += static_cast<char>('8' - i / 8);
+            out += '=';
+            out += cells[i];
+        }
+        out += '\n';
+    } else {
+        for (int i = 0; i < 64; ++i) {
+            out += cells[i];
+            out += (i % 8 == 7) ? '\n' : ' ';
         }
-        std::cout << '\n';
     }
-    std::cout << std::flush;
+    shown = cells;
+    std::cout << out << std::flush;
 }
 
 // Converts a square index (0..63) into algebraic notation (e.g. "e2")
@@ -66,78 +90,322 @@ int parseSquare(const std::string& s) {
     return (s[1] - '1') * 8 + (s[0] - 'a');
 }
 
+// Summary of a finished search as UCI "info" lines: the standard fields, then
+// the search counters as an "info string" (absent when they are compiled out)
+std::string statsInfo(const SearchStats& st) {
+    std::ostringstream out;
+    int64_t ms = std::max<int64_t>(st.timeMs, 1);
+    out << "info depth " << st.depth << " seldepth " << st.selDepth << " nodes " << st.nodes
+        << " time " << st.timeMs << " nps " << st.nodes * 1000 / ms;
+#ifndef TDLOG_NO_SEARCH_STATS
+    out.setf(std::ios::fixed);
+    out.precision(1);
+    out << "\ninfo string stats qnodes " << st.qnodes
+        << " tthit " << 100.0 * st.ttHitRate() << "% ttcut " << st.ttCutoffs
+        << " fmc " << 100.0 * st.firstMoveCutoffRate() << "%"
+        << " ebf " << st.branchingFactor()
+        << " rfp " << st.rfpPrunes << " nmp " << st.nullMoveCutoffs << "/" << st.nullMoveTries
+        << " iir " << st.iirReductions << " lmp " << st.lmpPrunes << " fut " << st.futilityPrunes
+        << " lmr " << st.lmrReductions << " research " << st.lmrResearches << " delta " << st.deltaPrunes;
+#endif
+    return out.str();
+}
+
+// UCI "info" line of one completed iteration
+std::string iterationInfo(const SearchInfo& info) {
+    std::ostringstream out;
+    out << "info depth " << info.depth << " seldepth " << info.selDepth << " multipv " << info.multiPv;
+    if (info.mateIn != 0) out << " score mate " << info.mateIn;
+    else                  out << " score cp " << info.score;
+    int64_t ms = std::max<int64_t>(info.timeMs, 1);
+    out << " nodes " << info.nodes << " nps " << info.nodes * 1000 / ms << " time " << info.timeMs
+        << " hashfull " << info.hashFull;
+    if (!info.pv.empty()) {
+        out << " pv";
+        for (const auto& m : info.pv) out << " " << moveToUci(m);
+    }
+    return out.str();
+}
+
+// Plays a UCI-style move (e.g., "e2e4", "e7e8q"); false if it is malformed or illegal
+bool playUciMove(Game& game, const std::string& moveStr) {
+    Move m = moveFromUci(moveStr);
+    return m.from >= 0 && game.playMove(m);
+}
+
+// Share of the remaining clock spent on one move (milliseconds)
+int64_t allocateTime(int64_t timeLeft, int64_t inc, int64_t movesToGo) {
+    if (movesToGo <= 0) movesToGo = 30;
+    int64_t budget = timeLeft / movesToGo + inc / 2;
+    // Keep a safety margin for the GUI / pipe latency
+    if (budget > timeLeft - 50) budget = timeLeft - 50;
+    if (budget < 1) budget = 1;
+    return budget;
+}
+
 // ======================================================
 //                 UCI MODE (ENGINE LOOP)
 // ======================================================
 // Minimal implementation of the UCI protocol
+// The search runs on the AI's background thread, so this loop keeps
+// answering isready / stop / ponderhit / quit while the engine thinks.
 void uci_loop() {
+    Variant variant = Variant::Classic; // UCI_Variant, used by ucinewgame / position startpos
     Game game;
-    game.startGame(Variant::Classic);
-
-    // AI used in UCI mode
-    AI bot(new MaterialAndPositionEvaluation(), 6);
+    game.startGame(variant);
+
+    // Position of the last "position" command: its base and the moves played from it
+    std::string positionBase;
+    std::vector<std::string> positionMoves;
+
+    // The search thread also writes (info / bestmove): all output goes through this queue
+    UciWriter writer(std::cout);
+
+    // AI used in UCI mode (material evaluation until an EvalFile is loaded)
+    AI bot(new NNUEEvaluation(), 6);
+    // The reported PV must be the move played: no random pick among close root moves
+    bot.setRandomRootChoice(false);
+
+    // "go ponder" and "go infinite" must not print bestmove before ponderhit / stop
+    std::mutex searchMutex;
+    std::condition_variable searchCv;
+    bool holdBestMove = false;
+    bool pondering = false;
+    bool infiniteGo = false;
+    int64_t ponderBudget = 0; // time budget started on ponderhit
+
+    auto send = [&](const std::string& msg) {
+        writer.send(msg);
+    };
+
+    // Progress of the running search, after each completed iteration
+    bot.setInfoCallback([&](const SearchInfo& info) {
+        send(iterationInfo(info));
+    });
+
+    // Stops the running search (if any) and waits for its bestmove
+    auto stopSearch = [&]() {
+        {
+            std::lock_guard<std::mutex> lock(searchMutex);
+            holdBestMove = false;
+            pondering = false;
+        }
+        searchCv.notify_all();
+        bot.stop();
+        bot.waitForSearch();
+    };
 
     std::string line, token;
 
     while (std::getline(std::cin, line)) {
         std::stringstream ss(line);
+        token.clear();
         ss >> token;
 
         if (token == "uci") {
             // Engine identification
-            std::cout << "id name TDLOG_Engine" << std::endl;
-            std::cout << "id author You" << std::endl;
-            std::cout << "uciok" << std::endl;
+            send("id name TDLOG_Engine");
+            send("id author You");
+            send("option name Ponder type check default false");
+            const SearchParams& p = bot.searchParams();
+            send("option name RFPMargin type spin default " + std::to_string(p.rfpMargin) + " min 0 max 1000");
+            send("option name FutilityMargin type spin default " + std::to_string(p.futilityMargin) + " min 0 max 1000");
+            send("option name LMPBase type spin default " + std::to_string(p.lmpBase) + " min 1 max 64");
+            send("option name EvalFile type string default <empty>");
+            send("option name MultiPV type spin default 1 min 1 max 64");
+            int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+            send("option name Threads type spin default " + std::to_string(cores) + " min 1 max 256");
+            send("option name Hash type spin default " + std::to_string(DEFAULT_HASH_MB) + " min 1 max 65536");
+            send("option name Clear Hash type button");
+            send("option name UCI_Variant type combo default classic var classic var fairy");
+            send("uciok");
+        }
+        else if (token == "setoption") {
+            // setoption name <id> [value <x>]
+            std::string word, name, value;
+            ss >> word; // "name"
+            while (ss >> word && word != "value") name += (name.empty() ? "" : " ") + word;
+            std::getline(ss >> std::ws, value); // may contain spaces (file paths)
+
+            SearchParams& p = bot.searchParams();
+            try {
+                // The search reads its parameters while it runs
+                if      (name == "RFPMargin")      { stopSearch(); p.rfpMargin = std::stoi(value); }
+                else if (name == "FutilityMargin") { stopSearch(); p.futilityMargin = std::stoi(value); }
+                else if (name == "LMPBase")        { stopSearch(); p.lmpBase = std::stoi(value); }
+                else if (name == "Threads") {
+                    stopSearch(); // the thread count is read when a search starts
+                    bot.setThreads(std::max(1, std::min(256, std::stoi(value))));
+                }
+                else if (name == "Hash") {
+                    stopSearch(); // the table is reallocated by the next search
+                    bot.setHashSize(static_cast<size_t>(std::max(1, std::min(65536, std::stoi(value)))));
+                }
+                else if (name == "Clear Hash") {
+                    stopSearch();
+                    bot.clearHash();
+                }
+                else if (name == "UCI_Variant") {
+                    stopSearch();
+                    variant = (value == "fairy") ? Variant::FairyChess : Variant::Classic;
+                    game.startGame(variant);
+                    positionBase.clear();
+                }
+                else if (name == "MultiPV") {
+                    stopSearch(); // the line count is read when a search starts
+                    bot.setMultiPV(std::max(1, std::min(64, std::stoi(value))));
+                }
+                else if (name == "EvalFile") {
+                    stopSearch(); // boards of a running search use the current weights
+                    if (!nnueLoad(value)) send("info string cannot load network " + value);
+                }
+            } catch (const std::exception&) {
+                // Malformed value: keep the previous setting
+            }
         }
         else if (token == "isready") {
-            std::cout << "readyok" << std::endl;
+            send("readyok");
         }
         else if (token == "ucinewgame") {
-            game.startGame(Variant::Classic);
+            stopSearch();
+            game.startGame(variant);
+            positionBase.clear();
+            bot.clearHash();
         }
         else if (token == "position") {
-            std::string sub;
+            // position (startpos | fen <fields>) [moves <m1> <m2> ...]
+            std::string sub, base;
             ss >> sub;
-
-            // Start from the standard initial position
             if (sub == "startpos") {
-                game.startGame(Variant::Classic);
-                ss >> sub;
+                base = "startpos";
+            } else if (sub == "fen") {
+                while (ss >> sub && sub != "moves") base += (base.empty() ? "" : " ") + sub;
+                if (base.empty()) continue;
+                base = "fen " + base;
+            } else {
+                continue;
             }
-
-            // Apply a sequence of moves
+            if (sub != "moves") ss >> sub;
+            std::vector<std::string> moves;
             if (sub == "moves") {
                 std::string moveStr;
-                while (ss >> moveStr) {
-                    int from = parseSquare(moveStr.substr(0, 2));
-                    int to   = parseSquare(moveStr.substr(2, 2));
-
-                    PieceType promo = PieceType::None;
-                    if (moveStr.length() > 4) {
-                        char p = moveStr[4];
-                        if      (p == 'q') promo = PieceType::Queen;
-                        else if (p == 'r') promo = PieceType::Rook;
-                        else if (p == 'b') promo = PieceType::Bishop;
-                        else if (p == 'n') promo = PieceType::Knight;
-                    }
+                while (ss >> moveStr) moves.push_back(moveStr);
+            }
 
-                    game.playMove(Move(from, to, promo));
+            // GUIs resend the whole game each move: when it extends the current
+            // position, only the new moves are played
+            bool extends = (base == positionBase && moves.size() >= positionMoves.size()
+                            && std::equal(positionMoves.begin(), positionMoves.end(), moves.begin()));
+            if (!extends) {
+                if (base == "startpos") {
+                    game.startGame(variant);
+                } else if (!game.setPosition(base.substr(4))) {
+                    send("info string invalid fen " + base.substr(4));
+                    positionBase.clear();
+                    positionMoves.clear();
+                    continue;
+                }
+                positionBase = base;
+                positionMoves.clear();
+            }
+            for (size_t i = positionMoves.size(); i < moves.size(); ++i) {
+                if (!playUciMove(game, moves[i])) {
+                    send("info string illegal move " + moves[i]);
+                    break;
                 }
+                positionMoves.push_back(moves[i]);
             }
         }
         else if (token == "go") {
-            // Ask the AI to compute the best move
-            Move best = bot.getBestMove(game.board(), game.currentTurn());
-            std::cout << "bestmove "
-                      << indexToSquare(best.from)
-                      << indexToSquare(best.to);
-            if (best.promotion != PieceType::None) std::cout << "q";
-            std::cout << std::endl;
+            stopSearch();
+
+            // Parse the search limits
+            SearchLimits limits;
+            int64_t wtime = 0, btime = 0, winc = 0, binc = 0, movesToGo = 0, moveTime = 0;
+            bool infinite = false, ponder = false;
+            std::string param;
+            while (ss >> param) {
+                if      (param == "wtime")     ss >> wtime;
+                else if (param == "btime")     ss >> btime;
+                else if (param == "winc")      ss >> winc;
+                else if (param == "binc")      ss >> binc;
+                else if (param == "movestogo") ss >> movesToGo;
+                else if (param == "movetime")  ss >> moveTime;
+                else if (param == "depth")     ss >> limits.depth;
+                else if (param == "infinite")  infinite = true;
+                else if (param == "ponder")    ponder = true;
+            }
+
+            bool white = (game.currentTurn() == Color::White);
+            int64_t timeLeft = white ? wtime : btime;
+            int64_t budget = moveTime;
+            if (budget == 0 && timeLeft > 0) budget = allocateTime(timeLeft, white ? winc : binc, movesToGo);
+
+            // While pondering the clock is the opponent's: our budget starts on ponderhit
+            limits.infinite = infinite || (ponder && budget > 0);
+            if (!ponder) limits.moveTimeMs = budget;
+
+            {
+                std::lock_guard<std::mutex> lock(searchMutex);
+                holdBestMove = infinite || ponder;
+                pondering = ponder;
+                infiniteGo = infinite;
+                ponderBudget = budget;
+            }
+
+            // Ask the AI to compute the best move in the background
+            Board rootBoard = game.board();
+            Color turn = game.currentTurn();
+            bot.startSearch(rootBoard, turn, limits, [&, rootBoard, turn](Move best) {
+                {
+                    std::unique_lock<std::mutex> lock(searchMutex);
+                    searchCv.wait(lock, [&] { return !holdBestMove; });
+                }
+                send(statsInfo(bot.lastSearchStats()));
+                std::string msg = "bestmove " + moveToUci(best);
+                Move ponderMove(-1, -1);
+                if (bot.getPonderMove(rootBoard, turn, best, ponderMove)) {
+                    msg += " ponder " + moveToUci(ponderMove);
+                }
+                send(msg);
+            });
+        }
+        else if (token == "ponderhit") {
+            // The expected move was played: keep searching, now on our own clock
+            int64_t budget = 0;
+            {
+                std::lock_guard<std::mutex> lock(searchMutex);
+                if (!pondering) continue;
+                pondering = false;
+                holdBestMove = infiniteGo;
+                budget = ponderBudget;
+            }
+            searchCv.notify_all();
+            if (budget > 0) bot.setTimeLimit(budget);
+        }
+        else if (token == "stop") {
+            stopSearch();
+        }
+        else if (token == "d") {
+            // Debug: current position
+            send("Fen: " + game.board().toFen(game.currentTurn()));
+        }
+        else if (token == "bench") {
+            // bench [depth] [threads]: same report as the command-line mode
+            stopSearch();
+            BenchConfig config;
+            if (!(ss >> config.depth)) config.depth = BenchConfig().depth;
+            if (!(ss >> config.threads)) config.threads = BenchConfig().threads;
+            std::ostringstream report;
+            runBench(config, report);
+            send(report.str());
         }
         else if (token == "quit") {
             break;
         }
     }
+
+    stopSearch();
 }
 
 // ======================================================
@@ -151,18 +419,42 @@ int main(int argc, char* argv[]) {
         return 0;
     }
 
+    // Self-play training data: datagen <games> <output> [nodes] [threads]
+    if (argc > 1 && std::string(argv[1]) == "datagen") {
+        DatagenConfig config;
+        if (argc > 2) config.games = std::stoi(argv[2]);
+        if (argc > 3) config.output = argv[3];
+        if (argc > 4) config.nodes = std::stoll(argv[4]);
+        if (argc > 5) config.threads = std::stoi(argv[5]);
+        return runDatagen(config);
+    }
+
+    // Fixed-depth search benchmark: bench [depth] [threads]
+    if (argc > 1 && std::string(argv[1]) == "bench") {
+        BenchConfig config;
+        if (argc > 2) config.depth = std::stoi(argv[2]);
+        if (argc > 3) config.threads = std::stoi(argv[3]);
+        runBench(config, std::cout);
+        return 0;
+    }
+
     // Default configuration
     Variant selectedVariant = Variant::Classic;
     std::string gamemode = "PvP";
     int depth[2] = {5, 5};
 
-    // Command-line arguments
-    if (argc > 1 && std::string(argv[1]) == "fairy") {
+    // Command-line arguments; "--diff" (anywhere) switches board updates to diffs
+    std::vector<std::string> args(argv, argv + argc);
+    auto diffFlag = std::remove(args.begin(), args.end(), std::string("--diff"));
+    bool diffUpdates = (diffFlag != args.end());
+    args.erase(diffFlag, args.end());
+
+    if (args.size() > 1 && args[1] == "fairy") {
         selectedVariant = Variant::FairyChess;
     }
-    if (argc > 2) gamemode = argv[2];
-    if (argc > 3) depth[0] = std::stoi(argv[3]);
-    if (argc > 4) depth[1] = std::stoi(argv[4]);
+    if (args.size() > 2) gamemode = args[2];
+    if (args.size() > 3) depth[0] = std::stoi(args[3]);
+    if (args.size() > 4) depth[1] = std::stoi(args[4]);
 
     // Game initialization
     Game g;
@@ -189,10 +481,12 @@ int main(int argc, char* argv[]) {
         players[1] = new AI(new MaterialAndPositionEvaluation(), depth[1]);
     }
 
-    // Initial board display
+    // Initial board display (always complete: diffs are relative to it)
     print_board_raw(g.board());
+    std::string shownCells = boardCells(g.board());
 
     std::string line;
+    std::string allReply; // "ALL" answer of the current position, empty until asked
     int player = 0;
 
     // ---------------- Main game loop ----------------
@@ -210,8 +504,8 @@ int main(int argc, char* argv[]) {
         if (bot) {
             Move bestMove = bot->getBestMove(g.board(), g.currentTurn());
             g.playMove(bestMove);
-            std::cout << "VAL" << std::endl;
-            print_board_raw(g.board());
+            allReply.clear();
+            print_board_update("VAL", g.board(), shownCells, diffUpdates);
             player = (player + 1) % 2;
         }
         else {
@@ -235,8 +529,7 @@ int main(int argc, char* argv[]) {
 
                 std::cout << "POS";
                 if (reqSq != -1) {
-                    std::vector<Move> moves = g.board().generateLegalMoves(g.currentTurn());
-                    for (const auto& m : moves) {
+                    for (const auto& m : g.legalMoves()) {
                         if (m.from == reqSq) {
                             std::cout << " " << indexToSquare(m.to);
                         }
@@ -244,6 +537,15 @@ int main(int argc, char* argv[]) {
                 }
                 std::cout << std::endl;
             }
+            else if (cmd == "ALL") {
+                // Every legal move of the position in one line (e.g. "ALL e2e4 e7e8q ...");
+                // the line is built once per position and reused until a move is played
+                if (allReply.empty()) {
+                    allReply = "ALL";
+                    for (const auto& m : g.legalMoves()) allReply += " " + moveToUci(m);
+                }
+                std::cout << allReply << std::endl;
+            }
             else if (cmd == "MOV") {
                 // Attempt to play a move
                 std::string sFrom, sTo, sPromo;
@@ -264,12 +566,11 @@ int main(int argc, char* argv[]) {
                 Move m(f, t, p);
 
                 if (g.playMove(m)) {
-                    std::cout << "VAL" << std::endl;
-                    print_board_raw(g.board());
+                    allReply.clear();
+                    print_board_update("VAL", g.board(), shownCells, diffUpdates);
                     player = (player + 1) % 2;
                 } else {
-                    std::cout << "ILL" << std::endl;
-                    print_board_raw(g.board());
+                    print_board_update("ILL", g.board(), shownCells, diffUpdates);
                 }
             }
         }
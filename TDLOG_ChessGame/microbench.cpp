@@ -0,0 +1,242 @@
+// Microbenchmarks of the board and search primitives (chess_bench target)
+//
+// Usage: chess_bench [filter] [samples]
+//   filter   only run benchmarks whose name contains this text
+//   samples  timed samples per benchmark (default 15)
+//
+// Each benchmark runs over the Classic and FairyChess positions of the bench suite.
+// A sample repeats the operation until it lasts at least 5 ms; the median and minimum
+// time per operation over all samples are reported, with TSC cycles on x86.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define MICROBENCH_RDTSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define MICROBENCH_RDTSC
+#endif
+
+#include "ai.h"
+#include "bench.h"
+
+// Results are folded into this sink so that the compiler cannot drop the work
+static volatile uint64_t sink = 0;
+
+// Forces an object to be materialized in memory (its address escapes)
+template <class T>
+static void escape(T& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    static const void* volatile slot;
+    slot = &value;
+#endif
+}
+
+static uint64_t readCycles() {
+#ifdef MICROBENCH_RDTSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Reaches the private TT functions of AI (friend of AI)
+struct TTBenchAccess {
+    static void allocate(AI& ai) {
+        ai.allocateHash();
+    }
+    static void store(AI& ai, uint64_t key, int score, int depth) {
+        ai.storeTT(key, score, depth, -INF, INF, Move(12, 28));
+    }
+    static bool probe(AI& ai, uint64_t key, int depth) {
+        int score = 0;
+        Move move(-1, -1);
+        return ai.probeTT(key, depth, -INF, INF, score, move);
+    }
+};
+
+// --- HARNESS ---
+
+struct Result {
+    double medianNs;
+    double minNs;
+    double medianCycles;
+};
+
+// A pass runs the operation over every position and returns how many operations it did
+using Pass = std::function<uint64_t()>;
+
+static Result measure(const Pass& pass, int samples) {
+    using Clock = std::chrono::steady_clock;
+
+    // Calibration: enough passes per sample to last at least 5 ms
+    int passes = 1;
+    while (true) {
+        auto start = Clock::now();
+        for (int i = 0; i < passes; ++i) pass();
+        if (std::chrono::duration<double, std::milli>(Clock::now() - start).count() >= 5.0) break;
+        passes *= 2;
+    }
+
+    std::vector<double> ns, cycles;
+    for (int s = 0; s < samples; ++s) {
+        uint64_t ops = 0;
+        uint64_t c0 = readCycles();
+        auto start = Clock::now();
+        for (int i = 0; i < passes; ++i) ops += pass();
+        double elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        uint64_t c1 = readCycles();
+        ns.push_back(elapsed / ops);
+        cycles.push_back(static_cast<double>(c1 - c0) / ops);
+    }
+    std::sort(ns.begin(), ns.end());
+    std::sort(cycles.begin(), cycles.end());
+    return { ns[ns.size() / 2], ns.front(), cycles[cycles.size() / 2] };
+}
+
+struct Benchmark {
+    std::string name;
+    Pass pass;
+};
+
+// --- BENCHMARKS ---
+
+// Benchmarks over one group of positions (all of the same variant)
+static std::vector<Benchmark> makeBenchmarks(const std::string& group, const std::vector<BenchPosition>& positions) {
+    std::vector<Benchmark> list;
+
+    // Legal moves of each position, generated once for the move-making benchmarks
+    std::vector<std::vector<Move>> legal;
+    for (const auto& p : positions) legal.push_back(p.board.generateLegalMoves(p.turn));
+
+    list.push_back({ "Board copy/" + group, [positions, legal]() {
+        uint64_t ops = 0;
+        for (size_t i = 0; i < positions.size(); ++i) {
+            for (size_t k = 0; k < legal[i].size(); ++k) {
+                Board b = positions[i].board;
+                escape(b);
+                ++ops;
+            }
+        }
+        return ops;
+    } });
+
+    list.push_back({ "Board copy + movePiece/" + group, [positions, legal]() {
+        uint64_t ops = 0;
+        for (size_t i = 0; i < positions.size(); ++i) {
+            for (const auto& m : legal[i]) {
+                Board b = positions[i].board;
+                b.movePiece(m.from, m.to, m.promotion);
+                escape(b);
+                ++ops;
+            }
+        }
+        return ops;
+    } });
+
+    list.push_back({ "generateLegalMoves/" + group, [positions]() {
+        for (const auto& p : positions) sink += p.board.generateLegalMoves(p.turn).size();
+        return static_cast<uint64_t>(positions.size());
+    } });
+
+    list.push_back({ "generateCaptures/" + group, [positions]() {
+        for (const auto& p : positions) sink += p.board.generateCaptures(p.turn).size();
+        return static_cast<uint64_t>(positions.size());
+    } });
+
+    list.push_back({ "isSquareAttacked/" + group, [positions]() {
+        uint64_t ops = 0;
+        for (const auto& p : positions) {
+            for (int sq = 0; sq < 64; ++sq) {
+                sink += p.board.isSquareAttacked(sq, Color::White);
+                sink += p.board.isSquareAttacked(sq, Color::Black);
+            }
+            ops += 128;
+        }
+        return ops;
+    } });
+
+    list.push_back({ "calculateHash/" + group, [positions]() {
+        for (const auto& p : positions) sink += p.board.calculateHash();
+        return static_cast<uint64_t>(positions.size());
+    } });
+
+    static MaterialAndPositionEvaluation eval;
+    list.push_back({ "MaterialAndPositionEvaluation/" + group, [positions]() {
+        for (const auto& p : positions) sink += static_cast<uint64_t>(eval(p.board));
+        return static_cast<uint64_t>(positions.size());
+    } });
+
+    // Batch of the same positions, to compare with the scalar row above
+    auto batch = std::make_shared<std::vector<Board>>();
+    for (const auto& p : positions) batch->push_back(p.board);
+    list.push_back({ "evaluateBatch (per position)/" + group, [batch]() {
+        std::vector<int> scores(batch->size());
+        eval.evaluateBatch(batch->data(), batch->size(), scores.data());
+        for (int s : scores) sink += static_cast<uint64_t>(s);
+        return static_cast<uint64_t>(batch->size());
+    } });
+
+    return list;
+}
+
+// TT operations on pseudo-random keys spread over the whole table
+static std::vector<Benchmark> makeTTBenchmarks(AI& ai) {
+    const uint64_t keyCount = 1 << 16;
+    auto keys = std::make_shared<std::vector<uint64_t>>(keyCount);
+    uint64_t x = 0x9E3779B97F4A7C15ull;
+    for (auto& k : *keys) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        k = x;
+    }
+
+    TTBenchAccess::allocate(ai);
+    std::vector<Benchmark> list;
+    list.push_back({ "TT store", [&ai, keys]() {
+        int i = 0;
+        for (uint64_t k : *keys) TTBenchAccess::store(ai, k, i++ & 255, 4);
+        return static_cast<uint64_t>(keys->size());
+    } });
+    list.push_back({ "TT probe", [&ai, keys]() {
+        for (uint64_t k : *keys) sink += TTBenchAccess::probe(ai, k, 2);
+        return static_cast<uint64_t>(keys->size());
+    } });
+    return list;
+}
+
+// --- MAIN ---
+
+int main(int argc, char* argv[]) {
+    std::string filter = (argc > 1) ? argv[1] : "";
+    int samples = (argc > 2) ? std::max(1, std::stoi(argv[2])) : 15;
+
+    std::vector<BenchPosition> classic, fairy;
+    for (auto& p : benchPositions()) (p.variant == Variant::Classic ? classic : fairy).push_back(p);
+
+    AI ai(new MaterialAndPositionEvaluation(), 1);
+    std::vector<Benchmark> benchmarks = makeBenchmarks("Classic", classic);
+    for (auto& b : makeBenchmarks("FairyChess", fairy)) benchmarks.push_back(b);
+    for (auto& b : makeTTBenchmarks(ai)) benchmarks.push_back(b);
+
+    std::printf("%-44s %12s %12s %12s\n", "benchmark", "median ns", "min ns", "cycles");
+    for (const auto& b : benchmarks) {
+        if (!filter.empty() && b.name.find(filter) == std::string::npos) continue;
+        Result r = measure(b.pass, samples);
+#ifdef MICROBENCH_RDTSC
+        std::printf("%-44s %12.1f %12.1f %12.1f\n", b.name.c_str(), r.medianNs, r.minNs, r.medianCycles);
+#else
+        std::printf("%-44s %12.1f %12.1f %12s\n", b.name.c_str(), r.medianNs, r.minNs, "-");
+#endif
+    }
+    return 0;
+}
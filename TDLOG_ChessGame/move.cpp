@@ -7,3 +7,44 @@ Position operator+(Position p1, Position p2) {
 Position operator-(Position p1, Position p2) {
     return {p1.x - p2.x, p1.y - p2.y};
 }
+
+std::string moveToUci(const Move& m) {
+    if (m.from < 0 || m.from == m.to) return "0000";
+    std::string s;
+    s += static_cast<char>('a' + m.from % 8);
+    s += static_cast<char>('1' + m.from / 8);
+    s += static_cast<char>('a' + m.to % 8);
+    s += static_cast<char>('1' + m.to / 8);
+    switch (m.promotion) {
+    case PieceType::Queen:  s += 'q'; break;
+    case PieceType::Rook:   s += 'r'; break;
+    case PieceType::Bishop: s += 'b'; break;
+    case PieceType::Knight: s += 'n'; break;
+    default: break;
+    }
+    return s;
+}
+
+// Square index of the two characters at text[at] (e.g. "e2"), -1 if off the board
+static int squareAt(const std::string& text, size_t at) {
+    char file = text[at], rank = text[at + 1];
+    if (file < 'a' || file > 'h' || rank < '1' || rank > '8') return -1;
+    return (rank - '1') * 8 + (file - 'a');
+}
+
+Move moveFromUci(const std::string& text) {
+    if (text.size() < 4) return Move();
+    int from = squareAt(text, 0);
+    int to   = squareAt(text, 2);
+    if (from < 0 || to < 0) return Move();
+
+    PieceType promo = PieceType::None;
+    if (text.size() > 4) {
+        char p = text[4];
+        if      (p == 'q') promo = PieceType::Queen;
+        else if (p == 'r') promo = PieceType::Rook;
+        else if (p == 'b') promo = PieceType::Bishop;
+        else if (p == 'n') promo = PieceType::Knight;
+    }
+    return Move(from, to, promo);
+}
@@ -47,6 +47,18 @@ struct Move {
      */
     Move(int f, int t, PieceType p = PieceType::None)
         : from(f), to(t), promotion(p) {}
+
+    /**
+     * @brief Construct an invalid move (-1, -1), used for empty slots in tables.
+     */
+    Move() : Move(-1, -1) {}
+
+    /**
+     * @brief Equality comparison on squares and promotion.
+     * @param o Other move.
+     * @return True if both moves have the same source, destination and promotion.
+     */
+    bool operator==(const Move& o) const { return from == o.from && to == o.to && promotion == o.promotion; }
 };
 
 /**
@@ -62,3 +74,21 @@ inline int toIndex(Position p) { return p.y * 8 + p.x; }
  * @return Board coordinate (x, y).
  */
 inline Position toPosition(int idx) { return {idx % 8, idx / 8}; }
+
+/**
+ * @brief Write a move in UCI long algebraic notation (e.g. "e2e4", "e7e8q").
+ * @param m Move to write.
+ * @return The move text, or "0000" for a null move (no legal move available).
+ */
+std::string moveToUci(const Move& m);
+
+/**
+ * @brief Read a move in UCI long algebraic notation (e.g. "e2e4", "e7e8q").
+ *
+ * Only the syntax is checked: the result still has to be validated against
+ * the legal moves of the position.
+ *
+ * @param text Move text.
+ * @return The move, or Move(-1, -1) if the text is malformed.
+ */
+Move moveFromUci(const std::string& text);
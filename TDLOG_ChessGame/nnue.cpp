@@ -0,0 +1,181 @@
+#include "nnue.h"
+#include "board.h"
+#include <fstream>
+#include <vector>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define NNUE_USE_SSE2
+#endif
+
+// --- NETWORK (Static) ---
+// Quantization: accumulator values are clipped to [0, QA] before the output layer,
+// output weights are scaled by QB, and the result is mapped back to centipawns with NNUE_SCALE.
+static const int QA = 255;
+static const int QB = 64;
+static const int NNUE_SCALE = 400;
+
+static std::vector<int16_t> featureBias;    // [hidden]
+static std::vector<int16_t> featureWeights; // [inputs][hidden]
+static std::vector<int16_t> outputWeights;  // [2 * hidden]: White perspective first, then Black
+static int32_t outputBias = 0;
+static uint32_t generation = 0;
+
+// Index of a piece's feature as seen from one perspective (Black sees the board mirrored)
+static inline int featureIndex(int perspective, Color c, PieceType pt, int square) {
+    int relColor = (static_cast<int>(c) == perspective) ? 0 : 1;
+    int relSquare = (perspective == 0) ? square : (square ^ 56);
+    return (relColor * 10 + static_cast<int>(pt)) * 64 + relSquare;
+}
+
+// acc += row (one weight row of NNUE_HIDDEN values)
+static inline void addRow(int16_t* acc, const int16_t* row) {
+#if defined(__AVX2__)
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(acc + i));
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(acc + i), _mm256_add_epi16(a, w));
+    }
+#elif defined(NNUE_USE_SSE2)
+    for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+        __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+        _mm_store_si128(reinterpret_cast<__m128i*>(acc + i), _mm_add_epi16(a, w));
+    }
+#else
+    for (int i = 0; i < NNUE_HIDDEN; ++i) acc[i] += row[i];
+#endif
+}
+
+// acc -= row
+static inline void subRow(int16_t* acc, const int16_t* row) {
+#if defined(__AVX2__)
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(acc + i));
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(acc + i), _mm256_sub_epi16(a, w));
+    }
+#elif defined(NNUE_USE_SSE2)
+    for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+        __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+        _mm_store_si128(reinterpret_cast<__m128i*>(acc + i), _mm_sub_epi16(a, w));
+    }
+#else
+    for (int i = 0; i < NNUE_HIDDEN; ++i) acc[i] -= row[i];
+#endif
+}
+
+// Sum of clamp(acc[i], 0, QA) * weights[i] over one perspective
+static inline int32_t clippedDot(const int16_t* acc, const int16_t* weights) {
+#if defined(__AVX2__)
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i qa = _mm256_set1_epi16(QA);
+    __m256i sum = _mm256_setzero_si256();
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(acc + i));
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+        a = _mm256_min_epi16(_mm256_max_epi16(a, zero), qa);
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(a, w));
+    }
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4E));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xB1));
+    return _mm_cvtsi128_si32(s);
+#elif defined(NNUE_USE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i qa = _mm_set1_epi16(QA);
+    __m128i sum = _mm_setzero_si128();
+    for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+        __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i));
+        a = _mm_min_epi16(_mm_max_epi16(a, zero), qa);
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(a, w));
+    }
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+    return _mm_cvtsi128_si32(sum);
+#else
+    int32_t sum = 0;
+    for (int i = 0; i < NNUE_HIDDEN; ++i) {
+        int v = acc[i] < 0 ? 0 : (acc[i] > QA ? QA : acc[i]);
+        sum += v * weights[i];
+    }
+    return sum;
+#endif
+}
+
+bool nnueLoad(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+
+    char magic[4];
+    uint32_t version = 0, inputs = 0, hidden = 0;
+    in.read(magic, 4);
+    in.read(reinterpret_cast<char*>(&version), sizeof(version));
+    in.read(reinterpret_cast<char*>(&inputs), sizeof(inputs));
+    in.read(reinterpret_cast<char*>(&hidden), sizeof(hidden));
+    if (!in || std::memcmp(magic, "TDNN", 4) != 0 || version != 1
+        || inputs != NNUE_INPUTS || hidden != NNUE_HIDDEN) {
+        return false;
+    }
+
+    std::vector<int16_t> bias(NNUE_HIDDEN), weights(NNUE_INPUTS * NNUE_HIDDEN), out(2 * NNUE_HIDDEN);
+    int32_t outBias = 0;
+    in.read(reinterpret_cast<char*>(bias.data()), bias.size() * sizeof(int16_t));
+    in.read(reinterpret_cast<char*>(weights.data()), weights.size() * sizeof(int16_t));
+    in.read(reinterpret_cast<char*>(out.data()), out.size() * sizeof(int16_t));
+    in.read(reinterpret_cast<char*>(&outBias), sizeof(outBias));
+    if (!in) return false;
+
+    featureBias = std::move(bias);
+    featureWeights = std::move(weights);
+    outputWeights = std::move(out);
+    outputBias = outBias;
+    ++generation;
+    return true;
+}
+
+uint32_t nnueGeneration() {
+    return generation;
+}
+
+void nnueRefresh(Accumulator& acc, const Board& board) {
+    acc.generation = generation;
+    if (generation == 0) return;
+
+    for (int p = 0; p < 2; ++p) {
+        std::memcpy(acc.values[p], featureBias.data(), NNUE_HIDDEN * sizeof(int16_t));
+    }
+    for (int c = 0; c < 2; ++c) {
+        for (int pt = 0; pt < 10; ++pt) {
+            Bitboard bb = board.getBitboard(static_cast<Color>(c), static_cast<PieceType>(pt));
+            while (bb) {
+                nnueAddFeature(acc, static_cast<Color>(c), static_cast<PieceType>(pt), __builtin_ctzll(bb));
+                bb &= (bb - 1);
+            }
+        }
+    }
+}
+
+void nnueAddFeature(Accumulator& acc, Color c, PieceType pt, int square) {
+    for (int p = 0; p < 2; ++p) {
+        addRow(acc.values[p], &featureWeights[featureIndex(p, c, pt, square) * NNUE_HIDDEN]);
+    }
+}
+
+void nnueRemoveFeature(Accumulator& acc, Color c, PieceType pt, int square) {
+    for (int p = 0; p < 2; ++p) {
+        subRow(acc.values[p], &featureWeights[featureIndex(p, c, pt, square) * NNUE_HIDDEN]);
+    }
+}
+
+int nnueOutput(const Accumulator& acc) {
+    int64_t sum = outputBias;
+    sum += clippedDot(acc.values[0], outputWeights.data());
+    sum += clippedDot(acc.values[1], outputWeights.data() + NNUE_HIDDEN);
+    return static_cast<int>(sum * NNUE_SCALE / (QA * QB));
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "piece.h"
+
+class Board;
+
+/**
+ * @brief Number of input features per perspective: [own/enemy color][piece type][square].
+ *
+ * All 10 piece types of @ref PieceType (classic + fairy) have their own features.
+ */
+const int NNUE_INPUTS = 2 * 10 * 64;
+
+/**
+ * @brief Number of hidden neurons per perspective (the accumulator width).
+ */
+const int NNUE_HIDDEN = 128;
+
+/**
+ * @brief First-layer outputs of the network for one position, kept up to date by the board.
+ *
+ * values[0] is computed from White's perspective, values[1] from Black's (board mirrored,
+ * colors swapped). Adding or removing a piece only adds or subtracts one weight row.
+ */
+struct Accumulator {
+    alignas(32) int16_t values[2][NNUE_HIDDEN];
+
+    /**
+     * @brief Generation of the network the values were computed with (0 = not computed).
+     */
+    uint32_t generation = 0;
+};
+
+/**
+ * @brief Load network weights from a binary file.
+ *
+ * Layout (little-endian): "TDNN", uint32 version (1), uint32 inputs, uint32 hidden,
+ * then int16 feature biases [hidden], int16 feature weights [inputs][hidden],
+ * int16 output weights [2 * hidden] and one int32 output bias.
+ * On failure the previously loaded network (if any) stays active.
+ *
+ * @param path Path of the weight file.
+ * @return True if the network was loaded.
+ */
+bool nnueLoad(const std::string& path);
+
+/**
+ * @brief Generation of the active network.
+ * @return 0 if no network is loaded, otherwise a counter bumped by each successful load.
+ */
+uint32_t nnueGeneration();
+
+/**
+ * @brief Recompute an accumulator from all the pieces of a board.
+ * @param acc Accumulator to fill.
+ * @param board Position to read.
+ */
+void nnueRefresh(Accumulator& acc, const Board& board);
+
+/**
+ * @brief Add the features of one piece to an accumulator.
+ * @param acc Accumulator to update.
+ * @param c Piece color.
+ * @param pt Piece type.
+ * @param square Square index (0..63).
+ */
+void nnueAddFeature(Accumulator& acc, Color c, PieceType pt, int square);
+
+/**
+ * @brief Remove the features of one piece from an accumulator.
+ * @param acc Accumulator to update.
+ * @param c Piece color.
+ * @param pt Piece type.
+ * @param square Square index (0..63).
+ */
+void nnueRemoveFeature(Accumulator& acc, Color c, PieceType pt, int square);
+
+/**
+ * @brief Run the output layer on an up-to-date accumulator.
+ * @param acc Accumulator computed with the active network.
+ * @return Evaluation in centipawns from White's perspective.
+ */
+int nnueOutput(const Accumulator& acc);
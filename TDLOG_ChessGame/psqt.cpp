@@ -0,0 +1,67 @@
+#include "psqt.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PSQT_USE_SSE2
+#endif
+
+#include "psqt_params.h"
+
+#include <mutex>
+
+// A white piece on square sq reads table entry (sq ^ 56), a black piece reads entry sq.
+
+const int phaseWeights[10] = { 0, 1, 1, 2, 4, 0, 3, 4, 2, 1 };
+
+Score psqtTable[2][10][64];
+static std::once_flag psqtInitialized;
+
+void initPsqt() {
+    // Boards may be created by several threads at once (datagen workers, the C API)
+    std::call_once(psqtInitialized, []() {
+        for (int p = 0; p < 10; ++p) {
+            for (int sq = 0; sq < 64; ++sq) {
+                int whiteIdx = sq ^ 56;
+                psqtTable[0][p][sq] = makeScore(mgMaterial[p] + mgTables[p][whiteIdx],
+                                                egMaterial[p] + egTables[p][whiteIdx]);
+                psqtTable[1][p][sq] = -makeScore(mgMaterial[p] + mgTables[p][sq],
+                                                 egMaterial[p] + egTables[p][sq]);
+            }
+        }
+    });
+}
+
+// The blend is done in single precision: every intermediate is an integer below 2^24,
+// so it is exact, and truncating the correctly rounded quotient matches integer division.
+void taperedValues(const Score* scores, const int* phases, size_t count, int* out) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256 maxPhase = _mm256_set1_ps(static_cast<float>(MAX_PHASE));
+    const __m256i half = _mm256_set1_epi32(0x8000);
+    for (; i + 8 <= count; i += 8) {
+        __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(scores + i));
+        __m256 mg = _mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(s, 16), 16));
+        __m256 eg = _mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_add_epi32(s, half), 16));
+        __m256 ph = _mm256_min_ps(_mm256_cvtepi32_ps(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(phases + i))), maxPhase);
+        __m256 blend = _mm256_add_ps(_mm256_mul_ps(mg, ph), _mm256_mul_ps(eg, _mm256_sub_ps(maxPhase, ph)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                            _mm256_cvttps_epi32(_mm256_div_ps(blend, maxPhase)));
+    }
+#elif defined(PSQT_USE_SSE2)
+    const __m128 maxPhase = _mm_set1_ps(static_cast<float>(MAX_PHASE));
+    const __m128i half = _mm_set1_epi32(0x8000);
+    for (; i + 4 <= count; i += 4) {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(scores + i));
+        __m128 mg = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(s, 16), 16));
+        __m128 eg = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_add_epi32(s, half), 16));
+        __m128 ph = _mm_min_ps(_mm_cvtepi32_ps(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(phases + i))), maxPhase);
+        __m128 blend = _mm_add_ps(_mm_mul_ps(mg, ph), _mm_mul_ps(eg, _mm_sub_ps(maxPhase, ph)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_cvttps_epi32(_mm_div_ps(blend, maxPhase)));
+    }
+#endif
+    for (; i < count; ++i) out[i] = taperedValue(scores[i], phases[i]);
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include "piece.h"
+
+/**
+ * @brief Packed middlegame/endgame score.
+ *
+ * The endgame value lives in the upper 16 bits and the middlegame value in the lower
+ * 16 bits, so both halves are accumulated with a single integer addition.
+ */
+using Score = int32_t;
+
+/**
+ * @brief Pack a middlegame and an endgame value into one @ref Score.
+ * @param mg Middlegame value.
+ * @param eg Endgame value.
+ * @return Packed score.
+ */
+inline Score makeScore(int mg, int eg) {
+    return static_cast<Score>((static_cast<uint32_t>(eg) << 16) + static_cast<uint32_t>(mg));
+}
+
+/**
+ * @brief Extract the middlegame half of a packed score.
+ * @param s Packed score.
+ * @return Middlegame value.
+ */
+inline int mgValue(Score s) {
+    return static_cast<int16_t>(static_cast<uint16_t>(static_cast<uint32_t>(s)));
+}
+
+/**
+ * @brief Extract the endgame half of a packed score.
+ * @param s Packed score.
+ * @return Endgame value.
+ */
+inline int egValue(Score s) {
+    return static_cast<int16_t>(static_cast<uint16_t>((static_cast<uint32_t>(s) + 0x8000u) >> 16));
+}
+
+/**
+ * @brief Game phase of the classic starting position.
+ *
+ * The phase is the sum of @ref phaseWeights over the pieces on the board; it is clamped
+ * to this value (fairy armies start above it) before blending MG and EG scores.
+ */
+const int MAX_PHASE = 24;
+
+/**
+ * @brief Phase contribution of each piece type (pawns and kings count for nothing).
+ */
+extern const int phaseWeights[10];
+
+/**
+ * @brief Material + piece-square values, signed from White's point of view.
+ *
+ * Indexed by [color][piece type][square]; black entries are negative.
+ * Filled by @ref initPsqt.
+ */
+extern Score psqtTable[2][10][64];
+
+/**
+ * @brief Build @ref psqtTable (static).
+ *
+ * Must be called at least once before a board is created; thread-safe.
+ */
+void initPsqt();
+
+/**
+ * @brief Blend a packed score according to the game phase.
+ * @param s Packed score (White's perspective).
+ * @param phase Game phase (0 = bare kings and pawns, @ref MAX_PHASE or more = opening).
+ * @return Tapered score (White's perspective).
+ */
+inline int taperedValue(Score s, int phase) {
+    if (phase > MAX_PHASE) phase = MAX_PHASE;
+    return (mgValue(s) * phase + egValue(s) * (MAX_PHASE - phase)) / MAX_PHASE;
+}
+
+/**
+ * @brief Blend many packed scores at once (SIMD when available).
+ *
+ * Same result as calling @ref taperedValue on each element.
+ *
+ * @param scores Packed scores (White's perspective).
+ * @param phases Game phase of each position.
+ * @param count Number of positions.
+ * @param out Output: tapered scores.
+ */
+void taperedValues(const Score* scores, const int* phases, size_t count, int* out);
@@ -0,0 +1,216 @@
+#pragma once
+
+// Evaluation parameters: material and piece-square tables (middlegame / endgame).
+// Generated by the tune tool (tune.cpp); regenerate rather than editing by hand.
+// Tables are written as seen from White's side: the first row is rank 8, the last row rank 1.
+// Piece order follows PieceType: Pawn, Knight, Bishop, Rook, Queen, King,
+// Princess, Empress, Nightrider, Grasshopper.
+
+static const int mgMaterial[10] = {  100,  320,  330,  500,  900,    0,  650,  850,  400,  300, };
+static const int egMaterial[10] = {  120,  300,  320,  540,  950,    0,  640,  880,  380,  260, };
+
+static const int mgTables[10][64] = {
+    { // Pawn
+           0,   0,   0,   0,   0,   0,   0,   0,
+          50,  50,  50,  50,  50,  50,  50,  50,
+          10,  10,  20,  30,  30,  20,  10,  10,
+           5,   5,  10,  25,  25,  10,   5,   5,
+           0,   0,   0,  20,  20,   0,   0,   0,
+           5,  -5, -10,   0,   0, -10,  -5,   5,
+           5,  10,  10, -20, -20,  10,  10,   5,
+           0,   0,   0,   0,   0,   0,   0,   0,
+    },
+    { // Knight
+         -50, -40, -30, -30, -30, -30, -40, -50,
+         -40, -20,   0,   5,   5,   0, -20, -40,
+         -30,   5,  10,  15,  15,  10,   5, -30,
+         -30,   0,  15,  20,  20,  15,   0, -30,
+         -30,   5,  15,  20,  20,  15,   5, -30,
+         -30,   0,  10,  15,  15,  10,   0, -30,
+         -40, -20,   0,   0,   0,   0, -20, -40,
+         -50, -40, -30, -30, -30, -30, -40, -50,
+    },
+    { // Bishop
+         -20, -10, -10, -10, -10, -10, -10, -20,
+         -10,   0,   0,   0,   0,   0,   0, -10,
+         -10,   0,   5,  10,  10,   5,   0, -10,
+         -10,   5,   5,  10,  10,   5,   5, -10,
+         -10,   0,  10,  10,  10,  10,   0, -10,
+         -10,  10,  10,  10,  10,  10,  10, -10,
+         -10,   5,   0,   0,   0,   0,   5, -10,
+         -20, -10, -10, -10, -10, -10, -10, -20,
+    },
+    { // Rook
+           0,   0,   0,   0,   0,   0,   0,   0,
+           5,  10,  10,  10,  10,  10,  10,   5,
+          -5,   0,   0,   0,   0,   0,   0,  -5,
+          -5,   0,   0,   0,   0,   0,   0,  -5,
+          -5,   0,   0,   0,   0,   0,   0,  -5,
+          -5,   0,   0,   0,   0,   0,   0,  -5,
+          -5,   0,   0,   0,   0,   0,   0,  -5,
+           0,   0,   0,   5,   5,   0,   0,   0,
+    },
+    { // Queen
+         -20, -10, -10,  -5,  -5, -10, -10, -20,
+         -10,   0,   0,   0,   0,   0,   0, -10,
+         -10,   0,   5,   5,   5,   5,   0, -10,
+          -5,   0,   5,   5,   5,   5,   0,  -5,
+           0,   0,   5,   5,   5,   5,   0,  -5,
+         -10,   5,   5,   5,   5,   5,   0, -10,
+         -10,   0,   5,   0,   0,   0,   0, -10,
+         -20, -10, -10,  -5,  -5, -10, -10, -20,
+    },
+    { // King
+         -30, -40, -40, -50, -50, -40, -40, -30,
+         -30, -40, -40, -50, -50, -40, -40, -30,
+         -30, -40, -40, -50, -50, -40, -40, -30,
+         -30, -40, -40, -50, -50, -40, -40, -30,
+         -20, -30, -30, -40, -40, -30, -30, -20,
+         -10, -20, -20, -20, -20, -20, -20, -10,
+          20,  20,   0,   0,   0,   0,  20,  20,
+          20,  30,  10,   0,   0,  10,  30,  20,
+    },
+    { // Princess
+         -30, -20, -15, -10, -10, -15, -20, -30,
+         -20,  -5,   0,   5,   5,   0,  -5, -20,
+         -15,   5,  10,  15,  15,  10,   5, -15,
+         -10,   5,  15,  20,  20,  15,   5, -10,
+         -10,   5,  15,  20,  20,  15,   5, -10,
+         -15,  10,  10,  15,  15,  10,  10, -15,
+         -20,   0,   0,   5,   5,   0,   0, -20,
+         -30, -20, -15, -10, -10, -15, -20, -30,
+    },
+    { // Empress
+         -20, -10,  -5,   0,   0,  -5, -10, -20,
+          -5,   5,  10,  10,  10,  10,   5,  -5,
+         -10,   5,  10,  15,  15,  10,   5, -10,
+         -10,   5,  15,  20,  20,  15,   5, -10,
+         -10,   5,  15,  20,  20,  15,   5, -10,
+         -10,   5,  10,  15,  15,  10,   5, -10,
+         -15,   0,   5,   5,   5,   5,   0, -15,
+         -20, -10,  -5,   0,   0,  -5, -10, -20,
+    },
+    { // Nightrider
+         -25, -15, -10, -10, -10, -10, -15, -25,
+         -15,  -5,   5,   5,   5,   5,  -5, -15,
+         -10,   5,  10,  10,  10,  10,   5, -10,
+         -10,   5,  10,  15,  15,  10,   5, -10,
+         -10,   5,  10,  15,  15,  10,   5, -10,
+         -10,   5,  10,  10,  10,  10,   5, -10,
+         -15,  -5,   0,   5,   5,   0,  -5, -15,
+         -25, -15, -10, -10, -10, -10, -15, -25,
+    },
+    { // Grasshopper
+         -20, -10, -10, -10, -10, -10, -10, -20,
+         -10,   0,   0,   0,   0,   0,   0, -10,
+         -10,   0,   5,   5,   5,   5,   0, -10,
+         -10,   0,   5,  10,  10,   5,   0, -10,
+         -10,   0,   5,  10,  10,   5,   0, -10,
+         -10,   0,   5,   5,   5,   5,   0, -10,
+         -10,   0,   0,   0,   0,   0,   0, -10,
+         -20, -10, -10, -10, -10, -10, -10, -20,
+    },
+};
+
+static const int egTables[10][64] = {
+    { // Pawn
+           0,   0,   0,   0,   0,   0,   0,   0,
+          80,  80,  80,  80,  80,  80,  80,  80,
+          50,  50,  50,  50,  50,  50,  50,  50,
+          30,  30,  30,  30,  30,  30,  30,  30,
+          15,  15,  15,  15,  15,  15,  15,  15,
+           5,   5,   5,   5,   5,   5,   5,   5,
+           0,   0,   0,   0,   0,   0,   0,   0,
+           0,   0,   0,   0,   0,   0,   0,   0,
+    },
+    { // Knight
+         -40, -30, -20, -20, -20, -20, -30, -40,
+         -30, -15,   0,   0,   0,   0, -15, -30,
+         -20,   0,  10,  15,  15,  10,   0, -20,
+         -20,   5,  15,  20,  20,  15,   5, -20,
+         -20,   5,  15,  20,  20,  15,   5, -20,
+         -20,   0,  10,  15,  15,  10,   0, -20,
+         -30, -15,   0,   5,   5,   0, -15, -30,
+         -40, -30, -20, -20, -20, -20, -30, -40,
+    },
+    { // Bishop
+         -15, -10, -10, -10, -10, -10, -10, -15,
+         -10,   0,   0,   0,   0,   0,   0, -10,
+         -10,   0,   5,   5,   5,   5,   0, -10,
+         -10,   0,   5,  10,  10,   5,   0, -10,
+         -10,   0,   5,  10,  10,   5,   0, -10,
+         -10,   0,   5,   5,   5,   5,   0, -10,
+         -10,   0,   0,   0,   0,   0,   0, -10,
+         -15, -10, -10, -10, -10, -10, -10, -15,
+    },
+    { // Rook
+           5,   5,   5,   5,   5,   5,   5,   5,
+          10,  10,  10,  10,  10,  10,  10,  10,
+           0,   0,   0,   0,   0,   0,   0,   0,
+           0,   0,   0,   0,   0,   0,   0,   0,
+           0,   0,   0,   0,   0,   0,   0,   0,
+           0,   0,   0,   0,   0,   0,   0,   0,
+           0,   0,   0,   0,   0,   0,   0,   0,
+           0,   0,   0,   0,   0,   0,   0,   0,
+    },
+    { // Queen
+         -20, -10, -10,  -5,  -5, -10, -10, -20,
+         -10,   0,   5,   5,   5,   5,   0, -10,
+         -10,   5,  10,  10,  10,  10,   5, -10,
+          -5,   5,  10,  15,  15,  10,   5,  -5,
+          -5,   5,  10,  15,  15,  10,   5,  -5,
+         -10,   5,  10,  10,  10,  10,   5, -10,
+         -10,   0,   5,   5,   5,   5,   0, -10,
+         -20, -10, -10,  -5,  -5, -10, -10, -20,
+    },
+    { // King
+         -50, -40, -30, -20, -20, -30, -40, -50,
+         -30, -20, -10,   0,   0, -10, -20, -30,
+         -30, -10,  20,  30,  30,  20, -10, -30,
+         -30, -10,  30,  40,  40,  30, -10, -30,
+         -30, -10,  30,  40,  40,  30, -10, -30,
+         -30, -10,  20,  30,  30,  20, -10, -30,
+         -30, -30,   0,   0,   0,   0, -30, -30,
+         -50, -30, -30, -30, -30, -30, -30, -50,
+    },
+    { // Princess
+         -30, -20, -15, -10, -10, -15, -20, -30,
+         -20,  -5,   0,   5,   5,   0,  -5, -20,
+         -15,   5,  10,  15,  15,  10,   5, -15,
+         -10,   5,  15,  20,  20,  15,   5, -10,
+         -10,   5,  15,  20,  20,  15,   5, -10,
+         -15,  10,  10,  15,  15,  10,  10, -15,
+         -20,   0,   0,   5,   5,   0,   0, -20,
+         -30, -20, -15, -10, -10, -15, -20, -30,
+    },
+    { // Empress
+         -20, -10,  -5,   0,   0,  -5, -10, -20,
+          -5,   5,  10,  10,  10,  10,   5,  -5,
+         -10,   5,  10,  15,  15,  10,   5, -10,
+         -10,   5,  15,  20,  20,  15,   5, -10,
+         -10,   5,  15,  20,  20,  15,   5, -10,
+         -10,   5,  10,  15,  15,  10,   5, -10,
+         -15,   0,   5,   5,   5,   5,   0, -15,
+         -20, -10,  -5,   0,   0,  -5, -10, -20,
+    },
+    { // Nightrider
+         -25, -15, -10, -10, -10, -10, -15, -25,
+         -15,  -5,   5,   5,   5,   5,  -5, -15,
+         -10,   5,  10,  10,  10,  10,   5, -10,
+         -10,   5,  10,  15,  15,  10,   5, -10,
+         -10,   5,  10,  15,  15,  10,   5, -10,
+         -10,   5,  10,  10,  10,  10,   5, -10,
+         -15,  -5,   0,   5,   5,   0,  -5, -15,
+         -25, -15, -10, -10, -10, -10, -15, -25,
+    },
+    { // Grasshopper
+         -20, -10, -10, -10, -10, -10, -10, -20,
+         -10,   0,   0,   0,   0,   0,   0, -10,
+         -10,   0,   5,   5,   5,   5,   0, -10,
+         -10,   0,   5,  10,  10,   5,   0, -10,
+         -10,   0,   5,  10,  10,   5,   0, -10,
+         -10,   0,   5,   5,   5,   5,   0, -10,
+         -10,   0,   0,   0,   0,   0,   0, -10,
+         -20, -10, -10, -10, -10, -10, -10, -20,
+    },
+};
@@ -0,0 +1,332 @@
+// Texel-style tuner for the evaluation parameters of psqt_params.h
+// (middlegame / endgame material and piece-square tables, fairy pieces included).
+//
+// Usage: tune <positions> [iterations] [output header] [threads]
+//
+// Positions are either a datagen record file (*.bin, see datagen.h) or text lines that
+// start with a FEN piece placement (fairy pieces: A = Princess, E = Empress,
+// H = Nightrider, G = Grasshopper) and contain the game result from White's point of
+// view: 1-0, 0-1, 1/2-1/2, or [1.0] / [0.5] / [0.0].
+// The rest of the evaluation (pawn structure...) is kept as a fixed offset per position.
+
+#include "ai.h"
+#include "board.h"
+#include "datagen.h"
+#include "psqt.h"
+#include "psqt_params.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// --- PARAMETER LAYOUT ---
+const int MG_MATERIAL = 0;
+const int EG_MATERIAL = 10;
+const int MG_TABLES = 20;
+const int EG_TABLES = MG_TABLES + 10 * 64;
+const int NUM_PARAMS = EG_TABLES + 10 * 64;
+const int KING = static_cast<int>(PieceType::King);
+
+const char* const pieceNames[10] = {
+    "Pawn", "Knight", "Bishop", "Rook", "Queen", "King",
+    "Princess", "Empress", "Nightrider", "Grasshopper"
+};
+
+// One piece of a position: table entry p * 64 + tableSquare, +1 for White, -1 for Black
+struct Feature {
+    uint16_t index;
+    int8_t sign;
+};
+
+// Precomputed per-position data: everything an iteration needs, nothing else
+struct TunePosition {
+    uint32_t first;  // first feature in the shared feature array
+    uint8_t count;   // number of pieces
+    uint8_t phase;   // clamped to MAX_PHASE
+    float result;    // 1 = White won, 0.5 = draw, 0 = Black won
+    float offset;    // evaluation terms that are not tuned
+};
+
+struct Dataset {
+    std::vector<TunePosition> positions;
+    std::vector<Feature> features;
+};
+
+// --- INPUT ---
+
+static bool parseResult(const std::string& line, float& result) {
+    if (line.find("1/2-1/2") != std::string::npos || line.find("[0.5]") != std::string::npos) result = 0.5f;
+    else if (line.find("1-0") != std::string::npos || line.find("[1.0]") != std::string::npos) result = 1.0f;
+    else if (line.find("0-1") != std::string::npos || line.find("[0.0]") != std::string::npos) result = 0.0f;
+    else return false;
+    return true;
+}
+
+// Reads the labeled positions and builds the feature cache.
+// Boards are evaluated by chunks through the batch API to get the untuned part of the score.
+static Dataset loadDataset(const std::string& path, const EvaluationFunctions& eval) {
+    Dataset data;
+    bool binary = path.size() > 4 && path.compare(path.size() - 4, 4, ".bin") == 0;
+    std::ifstream in(path, binary ? std::ios::binary : std::ios::in);
+    if (!in) {
+        std::cerr << "tune: cannot open " << path << std::endl;
+        return data;
+    }
+
+    const size_t CHUNK = 4096;
+    std::vector<Board> boards;
+    std::vector<float> results;
+    std::vector<int> scores(CHUNK);
+    boards.reserve(CHUNK);
+
+    auto flush = [&]() {
+        eval.evaluateBatch(boards.data(), boards.size(), scores.data());
+        for (size_t i = 0; i < boards.size(); ++i) {
+            const Board& board = boards[i];
+            TunePosition pos;
+            pos.first = static_cast<uint32_t>(data.features.size());
+            pos.phase = static_cast<uint8_t>(std::min(board.getPhase(), MAX_PHASE));
+            pos.result = results[i];
+            pos.offset = static_cast<float>(scores[i] - taperedValue(board.getPsqtScore(), board.getPhase()));
+            for (int c = 0; c < 2; ++c) {
+                for (int p = 0; p < 10; ++p) {
+                    Bitboard bb = board.getBitboard(static_cast<Color>(c), static_cast<PieceType>(p));
+                    while (bb) {
+                        int sq = __builtin_ctzll(bb);
+                        int tableSq = (c == 0) ? (sq ^ 56) : sq;
+                        data.features.push_back({ static_cast<uint16_t>(p * 64 + tableSq),
+                                                  static_cast<int8_t>(c == 0 ? 1 : -1) });
+                        bb &= (bb - 1);
+                    }
+                }
+            }
+            pos.count = static_cast<uint8_t>(data.features.size() - pos.first);
+            data.positions.push_back(pos);
+        }
+        boards.clear();
+        results.clear();
+    };
+
+    auto add = [&](const Board& board, float result) {
+        boards.push_back(board);
+        results.push_back(result);
+        if (boards.size() == CHUNK) flush();
+    };
+
+    size_t skipped = 0;
+    Board board;
+    if (binary) {
+        PackedPosition record;
+        while (in.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+            if (unpackPosition(record, board)) add(board, (record.result + 1) / 2.0f);
+            else ++skipped;
+        }
+    } else {
+        std::string line;
+        while (std::getline(in, line)) {
+            std::istringstream ss(line);
+            std::string placement;
+            float result;
+            Color turn;
+            if ((ss >> placement) && parseResult(line, result) && board.loadFen(placement, turn)) add(board, result);
+            else ++skipped;
+        }
+    }
+    if (!boards.empty()) flush();
+    if (skipped) std::cerr << "tune: skipped " << skipped << " unreadable lines" << std::endl;
+    return data;
+}
+
+// --- MODEL ---
+
+static inline double evaluate(const Dataset& data, const TunePosition& pos, const std::vector<double>& params) {
+    double mg = 0, eg = 0;
+    for (uint32_t i = pos.first; i < pos.first + pos.count; ++i) {
+        const Feature& f = data.features[i];
+        int piece = f.index / 64;
+        mg += f.sign * (params[MG_MATERIAL + piece] + params[MG_TABLES + f.index]);
+        eg += f.sign * (params[EG_MATERIAL + piece] + params[EG_TABLES + f.index]);
+    }
+    return pos.offset + (mg * pos.phase + eg * (MAX_PHASE - pos.phase)) / MAX_PHASE;
+}
+
+static inline double sigmoid(double k, double eval) {
+    return 1.0 / (1.0 + std::exp(-k * eval));
+}
+
+// Runs body(begin, end, thread) over [0, count) split across all cores
+template <typename Body>
+static void parallelFor(size_t count, int numThreads, Body body) {
+    std::vector<std::thread> threads;
+    size_t chunk = (count + numThreads - 1) / numThreads;
+    for (int t = 0; t < numThreads; ++t) {
+        size_t begin = std::min(count, t * chunk), end = std::min(count, begin + chunk);
+        threads.emplace_back(body, begin, end, t);
+    }
+    for (auto& th : threads) th.join();
+}
+
+// Mean squared error between results and sigmoid-mapped evaluations
+static double meanError(const Dataset& data, const std::vector<double>& params, double k, int numThreads) {
+    std::vector<double> partial(numThreads, 0.0);
+    parallelFor(data.positions.size(), numThreads, [&](size_t begin, size_t end, int t) {
+        double sum = 0;
+        for (size_t i = begin; i < end; ++i) {
+            const TunePosition& pos = data.positions[i];
+            double diff = pos.result - sigmoid(k, evaluate(data, pos, params));
+            sum += diff * diff;
+        }
+        partial[t] = sum;
+    });
+    double total = 0;
+    for (double p : partial) total += p;
+    return total / data.positions.size();
+}
+
+// Scaling constant of the sigmoid that best fits the current evaluation (golden-section search)
+static double fitK(const Dataset& data, const std::vector<double>& params, int numThreads) {
+    double lo = 0.0005, hi = 0.05;
+    const double ratio = (std::sqrt(5.0) - 1) / 2;
+    for (int it = 0; it < 40; ++it) {
+        double a = hi - ratio * (hi - lo), b = lo + ratio * (hi - lo);
+        if (meanError(data, params, a, numThreads) < meanError(data, params, b, numThreads)) hi = b;
+        else lo = a;
+    }
+    return (lo + hi) / 2;
+}
+
+static void computeGradient(const Dataset& data, const std::vector<double>& params, double k,
+                            int numThreads, std::vector<double>& gradient) {
+    std::vector<std::vector<double>> partial(numThreads, std::vector<double>(NUM_PARAMS, 0.0));
+    parallelFor(data.positions.size(), numThreads, [&](size_t begin, size_t end, int t) {
+        std::vector<double>& grad = partial[t];
+        for (size_t i = begin; i < end; ++i) {
+            const TunePosition& pos = data.positions[i];
+            double s = sigmoid(k, evaluate(data, pos, params));
+            double g = 2.0 * (s - pos.result) * s * (1.0 - s) * k;
+            double mgWeight = g * pos.phase / MAX_PHASE;
+            double egWeight = g * (MAX_PHASE - pos.phase) / MAX_PHASE;
+            for (uint32_t j = pos.first; j < pos.first + pos.count; ++j) {
+                const Feature& f = data.features[j];
+                int piece = f.index / 64;
+                grad[MG_MATERIAL + piece] += f.sign * mgWeight;
+                grad[MG_TABLES + f.index] += f.sign * mgWeight;
+                grad[EG_MATERIAL + piece] += f.sign * egWeight;
+                grad[EG_TABLES + f.index] += f.sign * egWeight;
+            }
+        }
+    });
+    std::fill(gradient.begin(), gradient.end(), 0.0);
+    for (const auto& grad : partial) {
+        for (int i = 0; i < NUM_PARAMS; ++i) gradient[i] += grad[i] / data.positions.size();
+    }
+}
+
+// --- OUTPUT ---
+
+static void writeHeader(const std::string& path, const std::vector<double>& params) {
+    std::ofstream out(path);
+    auto value = [&](int i) { return static_cast<int>(std::lround(params[i])); };
+
+    out << "#pragma once\n\n";
+    out << "// Evaluation parameters: material and piece-square tables (middlegame / endgame).\n";
+    out << "// Generated by the tune tool (tune.cpp); regenerate rather than editing by hand.\n";
+    out << "// Tables are written as seen from White's side: the first row is rank 8, the last row rank 1.\n";
+    out << "// Piece order follows PieceType: Pawn, Knight, Bishop, Rook, Queen, King,\n";
+    out << "// Princess, Empress, Nightrider, Grasshopper.\n\n";
+
+    auto material = [&](const char* name, int base) {
+        out << "static const int " << name << "[10] = {";
+        for (int p = 0; p < 10; ++p) out << std::setw(5) << value(base + p) << ",";
+        out << " };\n";
+    };
+    material("mgMaterial", MG_MATERIAL);
+    material("egMaterial", EG_MATERIAL);
+    out << "\n";
+
+    auto tables = [&](const char* name, int base) {
+        out << "static const int " << name << "[10][64] = {\n";
+        for (int p = 0; p < 10; ++p) {
+            out << "    { // " << pieceNames[p] << "\n";
+            for (int row = 0; row < 8; ++row) {
+                out << "        ";
+                for (int col = 0; col < 8; ++col) out << std::setw(4) << value(base + p * 64 + row * 8 + col) << ",";
+                out << "\n";
+            }
+            out << "    },\n";
+        }
+        out << "};\n";
+    };
+    tables("mgTables", MG_TABLES);
+    out << "\n";
+    tables("egTables", EG_TABLES);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: tune <positions> [iterations] [output header] [threads]" << std::endl;
+        return 1;
+    }
+    int iterations = (argc > 2) ? std::stoi(argv[2]) : 1000;
+    std::string output = (argc > 3) ? argv[3] : "psqt_params.h";
+    int numThreads = (argc > 4) ? std::stoi(argv[4]) : static_cast<int>(std::thread::hardware_concurrency());
+    numThreads = std::max(1, numThreads);
+
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&]() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    MaterialAndPositionEvaluation eval;
+    Dataset data = loadDataset(argv[1], eval);
+    if (data.positions.empty()) {
+        std::cerr << "tune: no positions" << std::endl;
+        return 1;
+    }
+    std::cout << "Loaded " << data.positions.size() << " positions in " << elapsed() << " s ("
+              << numThreads << " threads)" << std::endl;
+
+    // Start from the current parameters
+    std::vector<double> params(NUM_PARAMS);
+    for (int p = 0; p < 10; ++p) {
+        params[MG_MATERIAL + p] = mgMaterial[p];
+        params[EG_MATERIAL + p] = egMaterial[p];
+        for (int sq = 0; sq < 64; ++sq) {
+            params[MG_TABLES + p * 64 + sq] = mgTables[p][sq];
+            params[EG_TABLES + p * 64 + sq] = egTables[p][sq];
+        }
+    }
+
+    double k = fitK(data, params, numThreads);
+    std::cout << "K = " << k << ", initial error " << meanError(data, params, k, numThreads) << std::endl;
+
+    // Adam on the full batch
+    const double LEARNING_RATE = 1.0, BETA1 = 0.9, BETA2 = 0.999, EPSILON = 1e-8;
+    std::vector<double> gradient(NUM_PARAMS), m(NUM_PARAMS, 0.0), v(NUM_PARAMS, 0.0);
+    for (int it = 1; it <= iterations; ++it) {
+        computeGradient(data, params, k, numThreads, gradient);
+        gradient[MG_MATERIAL + KING] = gradient[EG_MATERIAL + KING] = 0; // kings are never traded
+        for (int i = 0; i < NUM_PARAMS; ++i) {
+            m[i] = BETA1 * m[i] + (1 - BETA1) * gradient[i];
+            v[i] = BETA2 * v[i] + (1 - BETA2) * gradient[i] * gradient[i];
+            double mHat = m[i] / (1 - std::pow(BETA1, it));
+            double vHat = v[i] / (1 - std::pow(BETA2, it));
+            params[i] -= LEARNING_RATE * mHat / (std::sqrt(vHat) + EPSILON);
+        }
+        if (it % 100 == 0 || it == iterations) {
+            std::cout << "Iteration " << it << ": error " << meanError(data, params, k, numThreads)
+                      << " (" << elapsed() << " s)" << std::endl;
+        }
+    }
+
+    writeHeader(output, params);
+    std::cout << "Wrote " << output << std::endl;
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include "uciwriter.h"
+
+UciWriter::UciWriter(std::ostream& out) : out(out) {
+    thread = std::thread(&UciWriter::run, this);
+}
+
+UciWriter::~UciWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+    }
+    wake.notify_one();
+    thread.join();
+}
+
+void UciWriter::send(std::string line) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(std::move(line));
+    }
+    wake.notify_one();
+}
+
+void UciWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    drained.wait(lock, [this] { return pending.empty() && !writing; });
+}
+
+void UciWriter::run() {
+    std::vector<std::string> batch;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return done || !pending.empty(); });
+        if (pending.empty()) break; // done, and nothing left to write
+
+        // Write outside the lock: senders only wait for the swap
+        batch.swap(pending);
+        writing = true;
+        lock.unlock();
+        for (const auto& line : batch) out << line << '\n';
+        out.flush();
+        batch.clear();
+        lock.lock();
+        writing = false;
+        if (pending.empty()) drained.notify_all();
+    }
+    drained.notify_all();
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Thread-safe buffered line writer used for the UCI output.
+ *
+ * send() only appends the line to a queue, so the search thread never blocks on a
+ * slow pipe. A background thread writes the queued lines in order and flushes the
+ * stream once per batch.
+ */
+class UciWriter {
+public:
+    /**
+     * @brief Start the writer thread.
+     * @param out Destination stream (typically std::cout).
+     */
+    explicit UciWriter(std::ostream& out);
+
+    /**
+     * @brief Write the remaining lines and stop the writer thread.
+     */
+    ~UciWriter();
+
+    UciWriter(const UciWriter&) = delete;
+    UciWriter& operator=(const UciWriter&) = delete;
+
+    /**
+     * @brief Queue one line (thread-safe); the newline is added by the writer.
+     * @param line Text to write.
+     */
+    void send(std::string line);
+
+    /**
+     * @brief Block until every queued line has been written and flushed.
+     */
+    void flush();
+
+private:
+    void run();
+
+    std::ostream& out;
+    std::vector<std::string> pending;
+    bool writing = false;
+    bool done = false;
+    std::mutex mutex;
+    std::condition_variable wake;    ///< Signals new lines (or shutdown) to the writer thread.
+    std::condition_variable drained; ///< Signals that the queue has been written.
+    std::thread thread;
+};
@@ -28,7 +28,7 @@ class Variante(enum.Enum):
 
 # --- MOTEUR ---
 class Engine():
-    def __init__(self, engine_path: str, variant: str, mode: str, ai_depth = [5, 5]):
+    def __init__(self, engine_path: str, variant: str, mode: str, ai_depth = [5, 5], diff: bool = True):
         if not os.path.exists(engine_path):
             raise FileNotFoundError(f"Moteur introuvable à : {engine_path}")
         
@@ -45,6 +45,10 @@ class Engine():
         elif mode == "AIvAI":
             cmd.append(str(ai_depth[0]))
             cmd.append(str(ai_depth[1]))
+
+        # Mises à jour du plateau en différentiel (seules les cases modifiées)
+        if diff:
+            cmd.append("--diff")
                 
         
         try:
@@ -90,6 +94,9 @@ class Engine():
             if prefix.startswith("POS"):
                 parts = prefix.split()
                 return "POS", parts[1:]
+            elif prefix.startswith("ALL"):
+                parts = prefix.split()
+                return "ALL", parts[1:]
             elif prefix == "PRO":
                 return "PRO", []
 
@@ -101,6 +108,8 @@ class Engine():
                     stripped = line.strip()
                     if not stripped: continue
                     lines.append(stripped)
+                    # Une ligne "DIF" remplace les 8 lignes du plateau
+                    if stripped.startswith("DIF"): break
                 return prefix, lines
             
             elif prefix == "END":
@@ -183,9 +192,7 @@ class Move():
         """Helper pour sélectionner proprement"""
         self.selected = pos
         self.highlight(col, row)
-        response = self.game.engine.send_request(f"POS {pos}")
-        if response and response[0] == "POS":
-            self.show_suggestions(response[1])
+        self.show_suggestions(self.game.legal_targets(pos))
 
 class Board():
     def __init__(self, var: Variante = Variante.CLASSIC):
@@ -201,6 +208,9 @@ class Board():
         return None if piece == "-" else piece
 
     def update(self, board_output: list): 
+        if len(board_output) == 1 and board_output[0].startswith("DIF"):
+            self.apply_diff(board_output[0].split()[1:])
+            return
         new_board = []
         for line in board_output:
             parts = line.split()
@@ -208,6 +218,15 @@ class Board():
             new_board.append(parts)
         self.board = new_board
 
+    def apply_diff(self, changes: list):
+        """Applique des changements de la forme 'e4=P' ('-' pour une case vide)."""
+        for change in changes:
+            if len(change) != 4 or change[2] != "=": continue
+            col = ord(change[0]) - ord('a')
+            row = 8 - int(change[1])
+            if 0 <= row < len(self.board) and 0 <= col < len(self.board[row]):
+                self.board[row][col] = change[3]
+
     def get_raw_data(self):
         return [row[:] for row in self.board]
 
@@ -241,6 +260,7 @@ class DisplayGame():
         self.board = Board(Variante.FAIRY if variant_str == "fairy" else Variante.CLASSIC)
         self.gamemode = mode 
         self.engine_mode = final_mode_arg 
+        self.legal_moves = None  # Coups légaux de la position affichée, par case de départ
         
         self.root.title(f"Chess : {self.gamemode} ({player_color})")
         
@@ -384,6 +404,17 @@ class DisplayGame():
         except Exception:
             pass
 
+    def legal_targets(self, pos):
+        """Cases d'arrivée légales depuis pos (une seule requête ALL par position)."""
+        if self.legal_moves is None:
+            prefix, moves = self.engine.send_request("ALL")
+            if prefix != "ALL": return []
+            self.legal_moves = {}
+            for move in moves:
+                targets = self.legal_moves.setdefault(move[:2], [])
+                if move[2:4] not in targets: targets.append(move[2:4])
+        return self.legal_moves.get(pos, [])
+
     def ask_engine(self, command=None):
         prefix, data = self.engine.send_request(command)
         if prefix in ["VAL", "ILL"] and data:
@@ -391,6 +422,7 @@ class DisplayGame():
         return prefix, data
 
     def act(self, answer: list):
+        self.legal_moves = None
         self.board.update(answer)
         self.draw_board()
 